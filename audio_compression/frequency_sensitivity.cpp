@@ -1,5 +1,5 @@
 //Illustration of frequency-dependent intensity sensitivity
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -29,16 +29,13 @@ class audio_data
     using CheckBoxType = imgutils::CheckBox<audio_data&>;
     CheckBoxType mute_checkbox;
     
-    void ResetGenerator()
+    void UpdateGenerator()
     {
-      if (player.IsPlaying())
-        player.Stop();
       const auto frequency = frequency_trackbar.GetValue();
       const auto level_percent = level_trackbar.GetValue();
       const auto level = comutils::GetValueFromLevel(-level_percent, 1); //Interpret trackbar position as (negative) level in dB (due to attenuation). The reference value is 1 since the amplitude is specified relatively, i.e., between 0 and 1.
-      generator.SetFrequency(frequency);
+      generator.SetFrequency(frequency); //Applied during playback without interruption
       generator.SetAmplitude(level);
-      player.Play(generator);
     }
     
     cv::Mat PlotWaves()
@@ -57,11 +54,21 @@ class audio_data
       return image;
     }
     
+    void ShowPlaybackStatus()
+    {
+      if (window.IsShown() && player.IsPlaying())
+      {
+        const std::string status_text = "Latency: " + comutils::FormatValue(1000 * player.GetEstimatedLatency(), 1) + " ms, underruns: " + std::to_string(player.GetUnderrunCount());
+        window.ShowOverlayText(status_text, true);
+      }
+    }
+    
     static void UpdateImage(audio_data &data)
     {
-      data.ResetGenerator();
+      data.UpdateGenerator();
       const cv::Mat image = data.PlotWaves();
       data.window.UpdateContent(image);
+      data.ShowPlaybackStatus();
     }
     
     static void Mute(audio_data &data)
@@ -94,8 +101,8 @@ class audio_data
        level_trackbar(level_trackbar_name, window, max_level, 0, default_level, UpdateImage, *this),
        mute_checkbox(mute_checkbox_name, window, false, Mute, Unmute, *this) //Unmuted by default
     {
-      ResetGenerator();
       UpdateImage(*this); //Update with default values
+      player.Play(generator);
     }
     
     void ShowImage()
@@ -1,24 +1,33 @@
 //Illustration of frequency masking
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
 #include <limits>
+#include <cmath>
+#include <string>
+#include <vector>
 #include <array>
 #include <algorithm>
 #include <set>
+#include <utility>
 
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
 
 #include "common.hpp"
 #include "sinewave.hpp"
-#include "mixer.hpp"
+#include "staticmixer.hpp"
 #include "player.hpp"
+#include "spectrum.hpp"
+#include "psychoacoustics.hpp"
 #include "math.hpp"
+#include "format.hpp"
 #include "plot.hpp"
 #include "colors.hpp"
 #include "combine.hpp"
+#include "canvas.hpp"
 #include "window.hpp"
 
 template<size_t N>
@@ -32,22 +41,27 @@ class audio_data
   
     using audio_type = short; //May be signed char (for 8 bits), short (16) or int (32)  
     using GeneratorType = comutils::SineWaveGenerator<audio_type>;
-    std::array<std::unique_ptr<GeneratorType>, N> generators; //Generators for each frequency
-    using MixerType = comutils::WaveFormMixer<audio_type, N>;
-    std::unique_ptr<MixerType> mixer;
+    using MixerType = comutils::UniformWaveFormMixer<audio_type, GeneratorType, N>;
+    MixerType mixer; //Holds the generators for each frequency
+    sndutils::SpectrumAnalyzer<audio_type> analyzer; //Declared before the player so that the player (and thereby the writing to the analyzer's tap) is stopped first
     sndutils::AudioPlayer<audio_type> player;
+    sndutils::MaskingModel masking_model;
   
     imgutils::Window window;
+    std::array<int, N> levels_percent;
+    cv::Mat wave_image; //Only changes with the levels
+    std::vector<double> spectrum;
+    std::vector<double> masking_threshold;
+    imgutils::Canvas plots_canvas; //Wave form (left) and spectrum (right)
+    imgutils::Canvas analysis_canvas; //Plots (top) and spectrogram (bottom)
     
     using TrackBarType = imgutils::TrackBar<audio_data&>;
     std::array<std::unique_ptr<TrackBarType>, N> level_trackbars;
     using CheckBoxType = imgutils::CheckBox<audio_data&>;
     CheckBoxType mute_checkbox;
      
-    std::array<int, N> ResetMixer()
+    std::array<int, N> UpdateLevels()
     {
-      if (player.IsPlaying())
-        player.Stop();
       std::array<int, N> levels_percent;
       std::transform(std::begin(level_trackbars), std::end(level_trackbars), levels_percent.begin(),
                      [](const std::unique_ptr<TrackBarType> &trackbar)
@@ -55,12 +69,11 @@ class audio_data
                          const auto level = trackbar->GetValue();
                          return level;
                        });
-      for (size_t i = 0; i < N; i++)
-      {
-        const auto amplitude = comutils::GetValueFromLevel(-levels_percent[i], 1); //Interpret trackbar position as (negative) level in dB (due to attenuation). The reference value is 1 since the amplitude is specified relatively, i.e., between 0 and 1.
-        generators[i]->SetAmplitude(amplitude);
-      }
-      player.Play(*mixer);
+      mixer.ForEachGenerator([&levels_percent](GeneratorType &generator, const size_t i)
+                                                                                       {
+                                                                                         const auto amplitude = comutils::GetValueFromLevel(-levels_percent[i], 1); //Interpret trackbar position as (negative) level in dB (due to attenuation). The reference value is 1 since the amplitude is specified relatively, i.e., between 0 and 1.
+                                                                                         generator.SetAmplitude(amplitude); //Applied during playback without interruption
+                                                                                       });
       return levels_percent;
     }
     
@@ -71,9 +84,11 @@ class audio_data
       std::array<std::vector<audio_type>, N + 1> samples;
       for (auto &sample_vector : samples)
         sample_vector.resize(displayed_samples);
-      for (size_t i = 0; i < N; i++)
-        generators[i]->GetRepresentativeSamples(samples[i].size(), samples[i].data());
-      mixer->GetRepresentativeSamples(samples[N].size(), samples[N].data());
+      mixer.ForEachGenerator([&samples](const GeneratorType &generator, const size_t i)
+                                                                                  {
+                                                                                    generator.GetRepresentativeSamples(samples[i].size(), samples[i].data());
+                                                                                  });
+      mixer.GetRepresentativeSamples(samples[N].size(), samples[N].data());
       
       std::vector<imgutils::PointSet> pointsets;
       for (size_t i = 0; i < N + 1; i++)
@@ -91,10 +106,25 @@ class audio_data
       return image;
     }
      
-    cv::Mat PlotSpectrum(const std::array<int, N> &levels_percent)
+    double GetMaxDisplayedFrequency() const
     {
-      const auto max_displayed_frequency = 1.5 * max_frequency;
+      return 1.5 * max_frequency;
+    }
+    
+    std::vector<cv::Point2d> GetDisplayedPoints(const std::vector<double> &levels)
+    {
+      std::vector<cv::Point2d> points;
+      for (size_t bin = 0; bin < levels.size() && analyzer.GetBinFrequency(bin) <= GetMaxDisplayedFrequency(); bin++)
+        points.emplace_back(analyzer.GetBinFrequency(bin), std::clamp(levels[bin], -static_cast<double>(max_level), 0.0)); //Clip levels outside of the displayed range
+      return points;
+    }
+    
+    cv::Mat PlotSpectrum()
+    {
+      const auto max_displayed_frequency = GetMaxDisplayedFrequency();
       std::vector<imgutils::PointSet> pointsets;
+      pointsets.emplace_back(GetDisplayedPoints(masking_threshold), imgutils::Green); //Masking threshold (below the spectrum)
+      pointsets.emplace_back(GetDisplayedPoints(spectrum), imgutils::Purple); //Spectrum of the signal which is played back (below the levels)
       for (size_t i = 0; i < N; i++)
       {
         const auto color = i == 0 ? imgutils::Red : imgutils::Blue;
@@ -109,14 +139,62 @@ class audio_data
       plot.DrawTo(image);
       return image;
     }
+    
+    cv::Mat PlotSpectrogram(const int width)
+    {
+      const auto spectrogram = analyzer.GetSpectrogram();
+      size_t displayed_bins = 0;
+      while (displayed_bins < analyzer.GetBinCount() && analyzer.GetBinFrequency(displayed_bins) <= GetMaxDisplayedFrequency())
+        displayed_bins++;
+      cv::Mat_<float> displayed_levels;
+      cv::flip(spectrogram.colRange(0, displayed_bins).t(), displayed_levels, 0); //Time from left to right, frequency from bottom to top
+      cv::Mat_<unsigned char> intensities;
+      displayed_levels.convertTo(intensities, CV_8U, 255.0 / max_level, 255); //Map levels between -max_level and 0 dB to intensities between 0 and 255
+      cv::Mat spectrogram_image;
+      cv::applyColorMap(intensities, spectrogram_image, cv::COLORMAP_INFERNO);
+      cv::resize(spectrogram_image, spectrogram_image, cv::Size(width, spectrogram_height), 0, 0, cv::INTER_NEAREST);
+      return spectrogram_image;
+    }
+     
+    std::string GetMaskedFrequencies() const
+    {
+      std::string masked_frequencies;
+      const double bin_spacing = analyzer.GetBinFrequency(1);
+      for (const auto frequency : frequencies)
+      {
+        const size_t bin = std::lround(frequency / bin_spacing);
+        if (spectrum[bin] < masking_threshold[bin]) //The tone is below the threshold caused by all components, i.e., inaudible
+          masked_frequencies += (masked_frequencies.empty() ? "" : ", ") + std::to_string(frequency) + " Hz";
+      }
+      return masked_frequencies.empty() ? "none" : masked_frequencies;
+    }
+     
+    void ShowPlaybackStatus()
+    {
+      if (window.IsShown() && player.IsPlaying())
+      {
+        const std::string status_text = "Latency: " + comutils::FormatValue(1000 * player.GetEstimatedLatency(), 1) + " ms, underruns: " + std::to_string(player.GetUnderrunCount()) + ", masked: " + GetMaskedFrequencies();
+        window.ShowOverlayText(status_text, true);
+      }
+    }
+     
+    void ShowAnalysis()
+    {
+      spectrum = analyzer.GetSpectrum();
+      masking_model.GetMaskingThreshold(spectrum, masking_threshold);
+      const cv::Mat spectrum_image = PlotSpectrum();
+      const cv::Mat &plots_image = imgutils::CombineImages({wave_image, spectrum_image}, plots_canvas, imgutils::CombinationMode::Horizontal);
+      const cv::Mat spectrogram_image = PlotSpectrogram(plots_image.cols);
+      const cv::Mat &combined_image = imgutils::CombineImages({plots_image, spectrogram_image}, analysis_canvas, imgutils::CombinationMode::Vertical);
+      window.UpdateContent(combined_image);
+      ShowPlaybackStatus();
+    }
      
     static void UpdateImage(audio_data &data)
     {
-      const auto levels_percent = data.ResetMixer();
-      const cv::Mat wave_image = data.PlotWaves();
-      const cv::Mat spectrum_image = data.PlotSpectrum(levels_percent);
-      const cv::Mat combined_image = imgutils::CombineImages({wave_image, spectrum_image}, imgutils::CombinationMode::Horizontal);
-      data.window.UpdateContent(combined_image);
+      data.levels_percent = data.UpdateLevels();
+      data.wave_image = data.PlotWaves();
+      data.ShowAnalysis();
     }
 
     static void Mute(audio_data &data)
@@ -131,17 +209,10 @@ class audio_data
 
     static constexpr auto trackbar_unit_name = " Hz level [-dB]";
     
-    void InitializeGenerators()
+    template<size_t... I>
+    static MixerType CreateMixer(const std::array<unsigned int, N> &frequencies, std::index_sequence<I...>)
     {
-      std::transform(std::begin(frequencies), std::end(frequencies), generators.begin(),
-                     [](const double frequency)
-                       {
-                         return std::make_unique<GeneratorType>(frequency);
-                       });
-      std::array<comutils::WaveFormGenerator<audio_type>*, N> generator_pointers;
-      for (size_t i = 0; i < N; i++)
-        generator_pointers[i] = generators[i].get();
-      mixer = std::make_unique<MixerType>(generator_pointers);
+      return MixerType(1.0 / N, frequencies[I]...); //One generator per frequency
     }
     
     void AddControls()
@@ -154,6 +225,8 @@ class audio_data
     }
     
     static constexpr auto window_name = "Attenuation";
+    static constexpr int spectrogram_height = 200; //In pixels
+    static constexpr int refresh_interval = 50; //Time in ms between updates of the spectrum and the spectrogram
     static constexpr auto mute_checkbox_name = "Mute";
   public:
     static constexpr unsigned int max_level = 100;
@@ -162,21 +235,25 @@ class audio_data
      : frequencies(frequencies),
        max_frequency(*std::max_element(std::begin(frequencies), std::end(frequencies))),
        default_levels(default_levels),
+       mixer(CreateMixer(frequencies, std::make_index_sequence<N>())),
+       masking_model(48000, analyzer.GetBinCount()), //Default sampling rate of the analyzer and the player
        window(window_name),
        mute_checkbox(mute_checkbox_name, window, false, Mute, Unmute, *this) //Unmuted by default
     {
       assert(std::set(frequencies.begin(), frequencies.end()).size() == frequencies.size()); //Check if any frequency occurs twice
       const auto max_default_level = *std::max_element(std::begin(default_levels), std::end(default_levels));
       assert(max_default_level <= max_level);
-      InitializeGenerators();
       AddControls();
-      ResetMixer();
       UpdateImage(*this); //Update with default values
+      player.SetTap(&analyzer.GetTap());
+      player.Play(mixer);
     }
     
     void ShowImage()
     {
-      window.ShowInteractive();
+      while (window.ShowInteractive(nullptr, refresh_interval, false) == -1) //Do not hide the window after each update; continue until a key is pressed
+        ShowAnalysis();
+      window.Hide();
     }
 };
 
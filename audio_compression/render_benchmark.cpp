@@ -0,0 +1,140 @@
+//Benchmark of audio rendering without a playback device
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <iostream>
+#include <limits>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include "sinewave.hpp"
+#include "mixer.hpp"
+#include "staticmixer.hpp"
+#include "player.hpp"
+#include "sink.hpp"
+#include "format.hpp"
+
+using audio_type = short; //May be signed char (for 8 bits), short (16) or int (32)
+
+static constexpr unsigned int sampling_rate = 48000;
+static constexpr size_t number_of_channels = 2;
+static constexpr unsigned int duration = 60; //In seconds
+static constexpr std::array frequencies { 400.0, 440.0, 523.25, 659.26, 783.99, 1046.5, 1318.5, 1568.0 };
+
+struct oscillator_engine
+{
+  const char * const name;
+  const comutils::OscillatorEngine engine;
+};
+
+static constexpr oscillator_engine oscillator_engines[] {{"Direct", comutils::OscillatorEngine::Direct},
+                                                         {"Recursive", comutils::OscillatorEngine::Recursive},
+                                                         {"Wave table", comutils::OscillatorEngine::WaveTable}};
+
+//Mixes one sine wave for each frequency through virtual generator interfaces, using the specified oscillator engine
+class tone_mix
+{
+  protected:
+    static constexpr size_t N = frequencies.size();
+    std::array<std::unique_ptr<comutils::SineWaveGenerator<audio_type>>, N> generators;
+    std::unique_ptr<comutils::WaveFormMixer<audio_type, N>> mixer;
+  public:
+    tone_mix(const comutils::OscillatorEngine engine)
+    {
+      std::array<comutils::WaveFormGenerator<audio_type>*, N> generator_pointers;
+      for (size_t i = 0; i < N; i++)
+      {
+        generators[i] = std::make_unique<comutils::SineWaveGenerator<audio_type>>(frequencies[i], 1.0, false, 0, sampling_rate);
+        generators[i]->SetOscillatorEngine(engine);
+        generator_pointers[i] = generators[i].get();
+      }
+      mixer = std::make_unique<comutils::WaveFormMixer<audio_type, N>>(generator_pointers, 1.0 / N, sampling_rate);
+    }
+
+    comutils::WaveFormGenerator<audio_type> &GetGenerator()
+    {
+      return *mixer;
+    }
+};
+
+//Mixes one sine wave for each frequency with generators known at compile time, using the specified oscillator engine
+class static_tone_mix
+{
+  protected:
+    using MixerType = comutils::UniformWaveFormMixer<audio_type, comutils::SineWaveGenerator<audio_type>, frequencies.size()>;
+    MixerType mixer;
+
+    template<size_t... I>
+    static MixerType CreateMixer(std::index_sequence<I...>)
+    {
+      return MixerType(1.0 / frequencies.size(), frequencies[I]...);
+    }
+  public:
+    static_tone_mix(const comutils::OscillatorEngine engine)
+     : mixer(CreateMixer(std::make_index_sequence<frequencies.size()>()))
+    {
+      mixer.ForEachGenerator([engine](comutils::SineWaveGenerator<audio_type> &generator, const size_t)
+                                                                                                     {
+                                                                                                       generator.SetOscillatorEngine(engine);
+                                                                                                     });
+    }
+
+    comutils::WaveFormGenerator<audio_type> &GetGenerator()
+    {
+      return mixer;
+    }
+};
+
+template<typename ToneMix>
+static void BenchmarkEngines(const char * const mixer_name)
+{
+  const sndutils::SampleFormat format {sampling_rate, number_of_channels, sizeof(audio_type)};
+  constexpr size_t frame_count = duration * sampling_rate;
+  for (const auto &oscillator_engine : oscillator_engines)
+  {
+    ToneMix mix(oscillator_engine.engine);
+    sndutils::NullAudioSink sink(format);
+    const auto start_time = std::chrono::steady_clock::now();
+    sndutils::Render(mix.GetGenerator(), sink, frame_count);
+    const std::chrono::duration<double> render_time = std::chrono::steady_clock::now() - start_time;
+    const double samples_per_second = sink.GetFrameCount() / render_time.count();
+    std::cout << oscillator_engine.name << " (" << mixer_name << "): " << comutils::FormatValue(samples_per_second / 1e6) << " million samples per second ("
+              << comutils::FormatValue(samples_per_second / sampling_rate, 1) << " times real time)" << std::endl;
+  }
+}
+
+static int WriteFile(const char * const filename)
+{
+  try
+  {
+    tone_mix mix(comutils::OscillatorEngine::Direct);
+    sndutils::WaveFileSink sink(filename, sndutils::SampleFormat {sampling_rate, number_of_channels, sizeof(audio_type)});
+    sndutils::Render(mix.GetGenerator(), sink, duration * sampling_rate);
+  }
+  catch (const std::runtime_error &error)
+  {
+    std::cerr << error.what() << std::endl;
+    return 2;
+  }
+  std::cout << "Wrote the mixed tones to '" << filename << "'" << std::endl;
+  return 0;
+}
+
+int main(const int argc, const char * const argv[])
+{
+  if (argc != 1 && argc != 2)
+  {
+    std::cout << "Measures how fast mixed tones can be rendered with different oscillators without a playback device." << std::endl;
+    std::cout << "Usage: " << argv[0] << " [<output WAV file>]" << std::endl;
+    return 1;
+  }
+  std::cout << "Rendering " << duration << " s of " << frequencies.size() << " mixed tones (" << number_of_channels << " channels, " << 8 * sizeof(audio_type) << " bits per sample)" << std::endl;
+  BenchmarkEngines<tone_mix>("virtual mixer");
+  BenchmarkEngines<static_tone_mix>("static mixer");
+  if (argc == 2)
+    return WriteFile(argv[1]);
+  return 0;
+}
@@ -1,5 +1,5 @@
 #Base Makefile for all folders with applications (source code plus executables)
-# Andreas Unterweger, 2018-2022
+# Andreas Unterweger, 2018-2026
 #This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #The directory that this file is contained in ($(CURDIR) does not change on include)
@@ -8,7 +8,7 @@ CURRENTPATH := $(dir $(lastword $(MAKEFILE_LIST)))
 include $(CURRENTPATH)common.mak
 
 #Keep intermediate object files to allow for parallel builds (make removes them otherwise)
-.PRECIOUS: %.o
+.PRECIOUS: %.o $(foreach target,$(DISPATCH_TARGETS),%.kernels.$(target).o)
 
 EXE := $(OBJ:.o=.exe)
 TST := $(addprefix test_, $(EXE:.exe=))
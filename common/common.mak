@@ -1,5 +1,5 @@
 #Common base for all Makefiles
-# Andreas Unterweger, 2016-2023
+# Andreas Unterweger, 2016-2026
 #This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #The directory that this file is contained in ($(CURDIR) does not change on include)
@@ -14,14 +14,29 @@ ifeq ($(DEBUG), 1)
   CXXFLAGS += -g -Wall -Wextra -Werror
   #CXXFLAGS += -Wpedantic #Uncomment once OpenCV's stitching header does not cause warnings/errors anymore
 else
-  CXXFLAGS += -O3 -flto -march=native -mtune=native
+  CXXFLAGS += -O3 -flto #No -march=native since kernels are compiled for multiple instruction sets and dispatched at runtime (see below)
 endif
 
 LDFLAGS += -pthread
+
 ifneq ($(DEBUG), 1)
   LDFLAGS += -O3 -flto
 endif
 
+#Kernels (*.kernels.cpp) are compiled once per dispatch target and selected at runtime (see cpudispatch.hpp). OpenCV's intrinsics are placed in a separate namespace per target.
+ifneq ($(filter x86_64% i386% i686%,$(shell $(CXX) -dumpmachine)),)
+  DISPATCH_TARGETS := Baseline SSE42 AVX2 AVX512
+else
+  DISPATCH_TARGETS := Baseline
+endif
+DISPATCHFLAGS_Baseline :=
+DISPATCHFLAGS_SSE42 := -msse4.2 -mpopcnt -DCV_CPU_DISPATCH_MODE=SSE4_2 -DCV_SSE3=1 -DCV_SSSE3=1 -DCV_SSE4_1=1 -DCV_SSE4_2=1 -DCV_POPCNT=1
+DISPATCHFLAGS_AVX2 := $(filter-out -DCV_CPU_DISPATCH_MODE=%,$(DISPATCHFLAGS_SSE42)) -mavx2 -mfma -DCV_CPU_DISPATCH_MODE=AVX2 -DCV_AVX=1 -DCV_AVX2=1 -DCV_FMA3=1
+DISPATCHFLAGS_AVX512 := $(filter-out -DCV_CPU_DISPATCH_MODE=%,$(DISPATCHFLAGS_AVX2)) -mavx512f -mavx512cd -mavx512bw -mavx512dq -mavx512vl -DCV_CPU_DISPATCH_MODE=AVX512_SKX -DCV_AVX_512F=1 -DCV_AVX_512CD=1 -DCV_AVX_512BW=1 -DCV_AVX_512DQ=1 -DCV_AVX_512VL=1 -DCV_AVX512_SKX=1
+
+#Maps source files to object files, yielding one object file per dispatch target for kernels
+ToObjects = $(patsubst %.cpp,%.o,$(filter-out %.kernels.cpp,$(1))) $(foreach target,$(DISPATCH_TARGETS),$(patsubst %.kernels.cpp,%.kernels.$(target).o,$(filter %.kernels.cpp,$(1))))
+
 SRCDEPS := comutils imgutils
 LIBS += opencv4
 ifneq ($(filter sound,$(PARTS)),)
@@ -34,7 +49,7 @@ endif
 SRCDEPS := $(addprefix $(COMMONPATH)/, $(SRCDEPS))
 CXXFLAGS += $(addprefix -I, $(SRCDEPS))
 SRCDEP := $(wildcard $(addsuffix /*.cpp, $(SRCDEPS)))
-OBJDEP := $(SRCDEP:.cpp=.o)
+OBJDEP := $(call ToObjects,$(SRCDEP))
 
 ifneq ($(LIBS),)
 	CXXFLAGS += `$(PKGCFG) --cflags $(LIBS)`
@@ -45,10 +60,16 @@ ifneq ($(LIBS),)
 endif
 
 SRC := $(wildcard *.cpp)
-OBJ := $(SRC:.cpp=.o)
+OBJ := $(call ToObjects,$(SRC))
 
 %.o: %.cpp
 	$(CXX) $< -o $@ $(CXXFLAGS)
 
+define KernelRule
+%.kernels.$(1).o: %.kernels.cpp
+	$$(CXX) $$< -o $$@ $$(CXXFLAGS) $$(DISPATCHFLAGS_$(1)) -DCPU_DISPATCH_TARGET=$(1)
+endef
+$(foreach target,$(DISPATCH_TARGETS),$(eval $(call KernelRule,$(target))))
+
 clean::
 	$(RM) $(OBJ)
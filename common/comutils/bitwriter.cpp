@@ -0,0 +1,60 @@
+//Bit writer class
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+
+#include "bitwriter.hpp"
+
+namespace comutils
+{
+  BitWriter::BitWriter()
+   : accumulator(0), free_bits(word_bits), bit_count(0) { }
+
+  void BitWriter::WriteBits(const uint32_t value, const unsigned int number_of_bits)
+  {
+    assert(number_of_bits <= 32);
+    assert(number_of_bits == 32 || (value >> number_of_bits) == 0); //Only the lowest number_of_bits bits may be set
+    bit_count += number_of_bits;
+    if (number_of_bits < free_bits) //Value fits into the current word with room to spare
+    {
+      free_bits -= number_of_bits;
+      accumulator |= static_cast<uint64_t>(value) << free_bits;
+    }
+    else //Value fills the current word exactly or spills over into the next one
+    {
+      const unsigned int remaining_bits = number_of_bits - free_bits;
+      accumulator |= static_cast<uint64_t>(value) >> remaining_bits;
+      words.push_back(accumulator);
+      free_bits = word_bits - remaining_bits;
+      accumulator = remaining_bits == 0 ? 0 : static_cast<uint64_t>(value) << free_bits; //Bits which have already been written are shifted out
+    }
+  }
+
+  void BitWriter::Flush()
+  {
+    if (free_bits == word_bits) //Nothing to flush
+      return;
+    words.push_back(accumulator);
+    accumulator = 0;
+    free_bits = word_bits;
+  }
+
+  void BitWriter::Clear()
+  {
+    words.clear();
+    accumulator = 0;
+    free_bits = word_bits;
+    bit_count = 0;
+  }
+
+  size_t BitWriter::GetBitCount() const
+  {
+    return bit_count;
+  }
+
+  const std::vector<uint64_t> &BitWriter::GetWords() const
+  {
+    return words;
+  }
+}
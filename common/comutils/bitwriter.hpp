@@ -0,0 +1,40 @@
+//Bit writer class (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace comutils
+{
+  //Writes variable-length codes into a buffer of 64-bit words (most significant bit first)
+  class BitWriter
+  {
+    public:
+      //Constructs a new, empty bit writer
+      BitWriter();
+
+      //Appends the lowest number_of_bits bits of value. At most 32 bits can be written at once.
+      void WriteBits(const uint32_t value, const unsigned int number_of_bits);
+      //Pads the last partially filled word with zeros and appends it to the buffer
+      void Flush();
+      //Discards all written bits without releasing the memory of the buffer
+      void Clear();
+
+      //Returns the number of bits written so far (without padding)
+      size_t GetBitCount() const;
+      //Returns the buffer of completely written words. Call Flush() first to include the last partially filled word.
+      const std::vector<uint64_t> &GetWords() const;
+
+    private:
+      static constexpr unsigned int word_bits = 64;
+
+      std::vector<uint64_t> words;
+      uint64_t accumulator; //Current (partially filled) word
+      unsigned int free_bits; //Number of bits not yet used in the current word
+      size_t bit_count;
+  };
+}
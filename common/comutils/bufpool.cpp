@@ -0,0 +1,99 @@
+//Buffer pool class
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cstdlib>
+#include <array>
+#include <vector>
+#include <mutex>
+#include <new>
+
+#include "bufpool.hpp"
+
+namespace comutils
+{
+  static constexpr size_t min_bucket = 12; //Smallest buffers are 2^12 bytes (4 KiB) in size
+  static constexpr size_t max_bucket = 8 * sizeof(size_t) - 1; //Largest power of two representable as size_t
+
+  static size_t GetBucket(const size_t size)
+  {
+    size_t bucket = min_bucket;
+    while (bucket < max_bucket && (static_cast<size_t>(1) << bucket) < size)
+      bucket++;
+    return bucket;
+  }
+
+  struct BufferPool::Buckets
+  {
+    mutable std::mutex mutex;
+    std::array<std::vector<unsigned char*>, max_bucket + 1> released_buffers;
+
+    ~Buckets()
+    {
+      for (auto &buffers : released_buffers)
+      {
+        for (const auto buffer : buffers)
+          std::free(buffer);
+      }
+    }
+  };
+
+  BufferPool::BufferPool()
+   : buckets(std::make_shared<Buckets>()) { }
+
+  BufferPool::Buffer BufferPool::Allocate(const size_t size)
+  {
+    const size_t bucket = GetBucket(size);
+    const size_t bucket_size = static_cast<size_t>(1) << bucket;
+    assert(bucket_size >= size);
+    unsigned char *memory = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(buckets->mutex);
+      auto &buffers = buckets->released_buffers[bucket];
+      if (!buffers.empty())
+      {
+        memory = buffers.back();
+        buffers.pop_back();
+      }
+    }
+    if (!memory)
+    {
+      static_assert(alignment >= alignof(std::max_align_t), "The alignment must be valid for aligned_alloc");
+      memory = static_cast<unsigned char*>(std::aligned_alloc(alignment, bucket_size)); //Bucket sizes are multiples of the alignment
+      if (!memory)
+        throw std::bad_alloc();
+    }
+    return Buffer(memory, [shared_buckets = buckets, bucket](unsigned char * const memory) //Keep the buckets alive as long as the buffer exists
+                            {
+                              std::lock_guard<std::mutex> lock(shared_buckets->mutex);
+                              shared_buckets->released_buffers[bucket].push_back(memory);
+                            });
+  }
+
+  void BufferPool::Trim()
+  {
+    std::lock_guard<std::mutex> lock(buckets->mutex);
+    for (auto &buffers : buckets->released_buffers)
+    {
+      for (const auto buffer : buffers)
+        std::free(buffer);
+      buffers.clear();
+    }
+  }
+
+  size_t BufferPool::GetAvailableBytes() const
+  {
+    std::lock_guard<std::mutex> lock(buckets->mutex);
+    size_t available_bytes = 0;
+    for (size_t bucket = 0; bucket < buckets->released_buffers.size(); bucket++)
+      available_bytes += buckets->released_buffers[bucket].size() * (static_cast<size_t>(1) << bucket);
+    return available_bytes;
+  }
+
+  BufferPool &BufferPool::GetDefault()
+  {
+    static BufferPool pool;
+    return pool;
+  }
+}
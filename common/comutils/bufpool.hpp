@@ -0,0 +1,39 @@
+//Buffer pool class (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace comutils
+{
+  //Pool of aligned memory buffers with power-of-two sizes (buckets) which are reused after they have been released
+  class BufferPool
+  {
+    public:
+      //Alignment of all buffers in bytes
+      static constexpr size_t alignment = 64;
+      //Memory buffer which is returned to the pool when the last reference to it is released
+      using Buffer = std::shared_ptr<unsigned char>;
+
+      //Constructs a new, empty pool
+      BufferPool();
+      BufferPool(const BufferPool &original) = delete; //Explicitly delete the copy constructor since buffers cannot belong to two pools
+
+      //Returns a buffer with at least the specified size in bytes, reusing a released buffer from the same bucket if there is one
+      Buffer Allocate(const size_t size);
+      //Frees all released buffers
+      void Trim();
+      //Returns the total size in bytes of all released buffers which are available for reuse
+      size_t GetAvailableBytes() const;
+
+      //Returns the pool shared by all users which do not specify one themselves
+      static BufferPool &GetDefault();
+
+    private:
+      struct Buckets; //Released buffers per bucket. They are shared with all allocated buffers so that these can still be returned once the pool is destroyed.
+      std::shared_ptr<Buckets> buckets;
+  };
+}
@@ -0,0 +1,62 @@
+//CPU feature detection and kernel dispatching
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cstdlib>
+#include <cstring>
+
+#include "cpudispatch.hpp"
+
+namespace comutils
+{
+  static constexpr CPUTarget targets[] {CPUTarget::Baseline, CPUTarget::SSE42, CPUTarget::AVX2, CPUTarget::AVX512};
+
+  static CPUTarget DetectCPUTarget()
+  {
+#if CPU_DISPATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+      return CPUTarget::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return CPUTarget::AVX2;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt"))
+      return CPUTarget::SSE42;
+#endif
+    return CPUTarget::Baseline;
+  }
+
+  static CPUTarget LimitCPUTarget(const CPUTarget target)
+  {
+    const char * const limit = std::getenv("CPU_DISPATCH_LIMIT");
+    if (!limit)
+      return target;
+    for (const auto limit_target : targets)
+    {
+      if (!strcmp(limit, GetCPUTargetName(limit_target)))
+        return limit_target < target ? limit_target : target;
+    }
+    return target; //Ignore unknown names
+  }
+
+  CPUTarget GetCPUTarget()
+  {
+    static const CPUTarget target = LimitCPUTarget(DetectCPUTarget());
+    return target;
+  }
+
+  const char *GetCPUTargetName(const CPUTarget target)
+  {
+    switch (target)
+    {
+      case CPUTarget::SSE42:
+        return "SSE4.2";
+      case CPUTarget::AVX2:
+        return "AVX2";
+      case CPUTarget::AVX512:
+        return "AVX-512";
+      case CPUTarget::Baseline:
+      default:
+        return "Baseline";
+    }
+  }
+}
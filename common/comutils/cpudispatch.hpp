@@ -0,0 +1,55 @@
+//CPU feature detection and kernel dispatching (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+  #define CPU_DISPATCH_X86 1 //Kernels are compiled for multiple x86 instruction set extensions (see common.mak)
+#else
+  #define CPU_DISPATCH_X86 0 //Kernels are only compiled for the baseline
+#endif
+
+#if defined(CPU_DISPATCH_TARGET) && CPU_DISPATCH_X86
+  #include <immintrin.h> //OpenCV only includes the SSE2 intrinsics for applications, so the intrinsics of the instruction sets enabled for the current kernel need to be included before any OpenCV header
+#endif
+
+//Concatenates the name of a kernel table and the name of a dispatch target
+#define CPU_DISPATCH_CONCAT(name, target) name##_##target
+#define CPU_DISPATCH_EXPAND_CONCAT(name, target) CPU_DISPATCH_CONCAT(name, target)
+//Name of a kernel table for the dispatch target that the current kernel translation unit is compiled for (CPU_DISPATCH_TARGET is defined by common.mak).
+//Kernel translation units must only call inline functions which are defined in their own translation unit or in OpenCV's target-specific intrinsics namespace, since the linker may otherwise pick a copy compiled for a more capable target.
+#define CPU_DISPATCH_NAME(name) CPU_DISPATCH_EXPAND_CONCAT(name, CPU_DISPATCH_TARGET)
+
+#if CPU_DISPATCH_X86
+  //Declares the kernel tables of all dispatch targets
+  #define CPU_DISPATCH_DECLARE(type, name) extern const type name##_Baseline, name##_SSE42, name##_AVX2, name##_AVX512
+  //Selects the kernel table of the most capable dispatch target supported by the CPU
+  #define CPU_DISPATCH_SELECT(name) comutils::SelectCPUTarget(name##_Baseline, name##_SSE42, name##_AVX2, name##_AVX512)
+#else
+  #define CPU_DISPATCH_DECLARE(type, name) extern const type name##_Baseline
+  #define CPU_DISPATCH_SELECT(name) (name##_Baseline)
+#endif
+
+namespace comutils
+{
+  //Instruction set extensions which kernels are compiled for (in ascending order)
+  enum class CPUTarget
+  {
+    Baseline, //No extensions beyond the compiler's default (SSE2 on x86-64)
+    SSE42, //SSE4.2 and POPCNT
+    AVX2, //AVX2 and FMA
+    AVX512 //AVX-512 F, CD, BW, DQ and VL (Skylake-X and newer)
+  };
+
+  //Returns the most capable dispatch target supported by the CPU and the operating system. The target can be limited by setting the environment variable CPU_DISPATCH_LIMIT to the name of a less capable target (see GetCPUTargetName), e.g., for comparisons. The target is only determined once.
+  CPUTarget GetCPUTarget();
+  //Returns the name of a dispatch target
+  const char *GetCPUTargetName(const CPUTarget target);
+
+  //Returns the kernel table of the dispatch target returned by GetCPUTarget
+  template<typename T>
+  const T &SelectCPUTarget(const T &baseline, const T &sse42, const T &avx2, const T &avx512);
+}
+
+#include "cpudispatch.impl.hpp"
@@ -0,0 +1,27 @@
+//CPU feature detection and kernel dispatching (template implementations)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+//#include "cpudispatch.hpp"
+
+namespace comutils
+{
+  template<typename T>
+  const T &SelectCPUTarget(const T &baseline, const T &sse42, const T &avx2, const T &avx512)
+  {
+    switch (GetCPUTarget())
+    {
+      case CPUTarget::AVX512:
+        return avx512;
+      case CPUTarget::AVX2:
+        return avx2;
+      case CPUTarget::SSE42:
+        return sse42;
+      case CPUTarget::Baseline:
+      default:
+        return baseline;
+    }
+  }
+}
@@ -1,10 +1,11 @@
 //Wave form mixer class (header)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "wavegen.hpp"
 
@@ -23,6 +24,8 @@ namespace comutils
       
       //Produces the next sample of the added weighted sum of all generators specified during construction. The weights are equal to the mixing factor.
       T GetNextSample();
+      //Produces the next N samples of the added weighted sum of all generators (see above)
+      void GenerateBlock(T values[], const size_t N);
       
       //Produces the added weighted sum of the first N representative samples of each generator
       void GetRepresentativeSamples(const size_t N, T values[]) const;
@@ -30,9 +33,13 @@ namespace comutils
     private:
       std::array<WaveFormGenerator<T>*, M> generators;
       double mixing_factor;
+      std::vector<T> component_values; //Block of samples of the current generator (reused for all blocks)
+      std::vector<double> mixed_values; //Weighted sum of the blocks of all generators (reused for all blocks)
       
       double MixValue(const double value) const;
       T ClipValue(const double value) const;
+      void AddMixedValues(const std::vector<T> &values, std::vector<double> &sums) const;
+      void ClipValues(const std::vector<double> &sums, T values[]) const;
       void VerifyGenerator(const WaveFormGenerator<T> * const generator) const;
   };
 }
@@ -1,8 +1,9 @@
 //Wave form mixer class (template implementation)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <cassert>
+#include <algorithm>
 #include <vector>
 
 //#include "mixer.hpp"
@@ -56,24 +57,53 @@ namespace comutils
     return ClipValue(sample_value);
   }
   
+  template<typename T, size_t M>
+  void WaveFormMixer<T, M>::AddMixedValues(const std::vector<T> &values, std::vector<double> &sums) const
+  {
+    assert(values.size() == sums.size());
+    for (size_t i = 0; i < values.size(); i++)
+      sums[i] += MixValue(values[i]);
+  }
+  
+  template<typename T, size_t M>
+  void WaveFormMixer<T, M>::ClipValues(const std::vector<double> &sums, T values[]) const
+  {
+    std::transform(sums.begin(), sums.end(), values, [this](const double value)
+                                                           {
+                                                             return ClipValue(value);
+                                                           });
+  }
+  
+  template<typename T, size_t M>
+  void WaveFormMixer<T, M>::GenerateBlock(T values[], const size_t N)
+  {
+    component_values.resize(N);
+    mixed_values.assign(N, 0.0);
+    for (auto * const generator : generators)
+    {
+      if (generator)
+      {
+        generator->GenerateBlock(component_values.data(), N);
+        AddMixedValues(component_values, mixed_values);
+      }
+    }
+    ClipValues(mixed_values, values);
+  }
+  
   template<typename T, size_t M>
   void WaveFormMixer<T, M>::GetRepresentativeSamples(const size_t N, T values[]) const
   {
     std::vector<double> sample_values(N, 0.0);
+    std::vector<T> representative_samples(N);
     for (auto * const generator : generators)
     {
       if (generator)
       {
-        std::vector<T> representative_samples(N);
         generator->GetRepresentativeSamples(N, representative_samples.data());
-        for (size_t i = 0; i < N; i++)
-          sample_values[i] +=  MixValue(representative_samples[i]);
+        AddMixedValues(representative_samples, sample_values);
       }
     }
-    std::transform(sample_values.begin(), sample_values.end(), values, [this](const double value)
-                                                                             {
-                                                                               return ClipValue(value);
-                                                                             });
+    ClipValues(sample_values, values);
   }
   
   template<typename T, size_t M>
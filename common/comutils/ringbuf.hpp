@@ -0,0 +1,48 @@
+//Lock-free single-producer/single-consumer ring buffer (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+namespace comutils
+{
+  //Ring buffer of elements of type T which is accessed concurrently by exactly one producer and one consumer thread without locking. The producer only modifies the write position and the consumer only the read position.
+  template<typename T>
+  class RingBuffer
+  {
+    public:
+      //Constructs a new, empty ring buffer which can hold at least the specified number of elements
+      RingBuffer(const size_t capacity);
+      RingBuffer(const RingBuffer &original) = delete; //Explicitly delete the copy constructor since the positions are shared between two threads
+
+      //Returns the maximum number of elements the buffer can hold
+      size_t GetCapacity() const;
+      //Returns the number of elements which can be read. The actual number may only be higher when called by the consumer.
+      size_t GetReadableCount() const;
+      //Returns the number of elements which can be written. The actual number may only be higher when called by the producer.
+      size_t GetWritableCount() const;
+
+      //Writes up to count elements and returns the number of elements written (producer only)
+      size_t Write(const T * const values, const size_t count);
+      //Reads up to count elements and returns the number of elements read (consumer only)
+      size_t Read(T * const values, const size_t count);
+      //Removes all elements. Must not be called while the producer or the consumer are accessing the buffer.
+      void Clear();
+
+    private:
+      static constexpr size_t cache_line_size = 64;
+
+      const size_t capacity; //Power of two so that positions can be wrapped with a mask
+      const std::unique_ptr<T[]> elements;
+      alignas(cache_line_size) std::atomic<size_t> write_position; //Total number of elements written (only modified by the producer)
+      size_t cached_read_position; //Last read position seen by the producer to avoid accessing the consumer's cache line on every write
+      alignas(cache_line_size) std::atomic<size_t> read_position; //Total number of elements read (only modified by the consumer)
+      size_t cached_write_position; //Last write position seen by the consumer to avoid accessing the producer's cache line on every read
+  };
+}
+
+#include "ringbuf.impl.hpp"
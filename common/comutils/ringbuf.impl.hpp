@@ -0,0 +1,87 @@
+//Lock-free single-producer/single-consumer ring buffer (template implementation)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+
+//#include "ringbuf.hpp"
+
+namespace comutils
+{
+  static constexpr size_t GetNextPowerOfTwo(const size_t value)
+  {
+    size_t power = 1;
+    while (power < value)
+      power <<= 1;
+    return power;
+  }
+
+  template<typename T>
+  RingBuffer<T>::RingBuffer(const size_t capacity)
+   : capacity(GetNextPowerOfTwo(capacity)), elements(new T[this->capacity]),
+     write_position(0), cached_read_position(0),
+     read_position(0), cached_write_position(0)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "T (ring buffer element type) must be trivially copyable");
+    assert(capacity > 0);
+  }
+
+  template<typename T>
+  size_t RingBuffer<T>::GetCapacity() const
+  {
+    return capacity;
+  }
+
+  template<typename T>
+  size_t RingBuffer<T>::GetReadableCount() const
+  {
+    return write_position.load(std::memory_order_acquire) - read_position.load(std::memory_order_acquire); //Positions only grow, so the difference is correct even when they overflow
+  }
+
+  template<typename T>
+  size_t RingBuffer<T>::GetWritableCount() const
+  {
+    return capacity - GetReadableCount();
+  }
+
+  template<typename T>
+  size_t RingBuffer<T>::Write(const T * const values, const size_t count)
+  {
+    const size_t position = write_position.load(std::memory_order_relaxed);
+    if (capacity - (position - cached_read_position) < count) //Only check the consumer's position if the cached one does not leave enough space
+      cached_read_position = read_position.load(std::memory_order_acquire);
+    const size_t written_count = std::min(count, capacity - (position - cached_read_position));
+    const size_t offset = position & (capacity - 1);
+    const size_t first_part = std::min(written_count, capacity - offset); //Elements up to the end of the buffer; the rest wraps around
+    std::copy(values, values + first_part, elements.get() + offset);
+    std::copy(values + first_part, values + written_count, elements.get());
+    write_position.store(position + written_count, std::memory_order_release); //Publish the elements
+    return written_count;
+  }
+
+  template<typename T>
+  size_t RingBuffer<T>::Read(T * const values, const size_t count)
+  {
+    const size_t position = read_position.load(std::memory_order_relaxed);
+    if (cached_write_position - position < count) //Only check the producer's position if the cached one does not provide enough elements
+      cached_write_position = write_position.load(std::memory_order_acquire);
+    const size_t read_count = std::min(count, cached_write_position - position);
+    const size_t offset = position & (capacity - 1);
+    const size_t first_part = std::min(read_count, capacity - offset); //Elements up to the end of the buffer; the rest wraps around
+    std::copy(elements.get() + offset, elements.get() + offset + first_part, values);
+    std::copy(elements.get(), elements.get() + (read_count - first_part), values + first_part);
+    read_position.store(position + read_count, std::memory_order_release); //Release the space
+    return read_count;
+  }
+
+  template<typename T>
+  void RingBuffer<T>::Clear()
+  {
+    write_position = 0;
+    read_position = 0;
+    cached_read_position = 0;
+    cached_write_position = 0;
+  }
+}
@@ -1,14 +1,25 @@
 //Sine wave generator class (header)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include "wavegen.hpp"
 
 namespace comutils
 {
-  //Defines a generator for sinusodial wave forms
+  //Method to compute consecutive samples of sine waves in GenerateBlock
+  enum class OscillatorEngine
+  {
+    Direct, //Evaluates sin for every sample (most precise)
+    Recursive, //Goertzel-style recursion with one multiplication and one subtraction per sample, resynchronized with the exact phase periodically to avoid drifting
+    WaveTable //Linear interpolation between the entries of a table with one period of a sine wave, which is band-limited by construction
+  };
+  
+  //Defines a generator for sinusodial wave forms. Amplitude, frequency and oscillator engine can be changed by other threads while samples are generated. Changes are applied at the beginning of the next block, with the amplitude being faded to its new value over 10 ms and the phase continuing seamlessly.
   template<typename T>
   class SineWaveGenerator : public WaveFormGenerator<T>
   {  
@@ -28,23 +39,38 @@ namespace comutils
       //Sets the frequency of the sine wave
       void SetFrequency(const double frequency);
       
+      //Returns the method used to compute samples in GenerateBlock
+      OscillatorEngine GetOscillatorEngine() const;
+      //Sets the method used to compute samples in GenerateBlock. GetNextSample and GetRepresentativeSamples always use the direct (most precise) method.
+      void SetOscillatorEngine(const OscillatorEngine engine);
+      
       //Produces the next sample of the sine wave
       T GetNextSample();
+      //Produces the next N samples of the sine wave
+      void GenerateBlock(T values[], const size_t N);
       
       //Produces first N samples of the sine wave
       void GetRepresentativeSamples(const size_t N, T values[]) const;
       
     private:
-      double amplitude;
-      double frequency;
+      std::atomic<double> amplitude;
+      std::atomic<double> frequency;
       bool absolute_amplitude;
-      double units_per_period;
-      double phase; //Current phase
-      double phase_shift; //Initial phase shift
+      double initial_phase; //In radians
+      std::atomic<OscillatorEngine> engine;
+      double phase; //Current phase in periods, i.e., between 0 and 1 (only accessed by the generating thread)
+      double current_amplitude; //Relative amplitude of the last generated block, from which amplitude changes are faded (only accessed by the generating thread)
+      bool generating; //Whether samples have been generated before. If not, there is nothing to fade from (only accessed by the generating thread).
+      std::vector<double> unit_values; //Samples of the current block with an amplitude of 1 (reused for all blocks)
+      
+      static constexpr size_t resynchronization_interval = 1024; //Number of samples after which the recursion is restarted from the exact phase
+      static constexpr size_t wave_table_size = 4096; //Number of table entries per period. The maximum interpolation error is below 3e-7 relative to the amplitude.
       
-      T GetSample(const double selected_phase) const;
+      static const std::vector<double> &GetWaveTable();
       
-      void SetPhaseShift(const double phase);
+      double GetRelativeAmplitude(const double selected_amplitude) const;
+      void GetUnitSamples(const double first_phase, const double selected_frequency, const size_t N, double values[], const OscillatorEngine selected_engine) const;
+      void GenerateSamples(T values[], const size_t N, const OscillatorEngine selected_engine);
   };
 }
 
@@ -1,9 +1,10 @@
 //Sine wave generator class (template implementation)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <cassert>
 #include <cmath>
+#include <algorithm>
 
 //#include "sinewave.hpp"
 
@@ -13,11 +14,12 @@ namespace comutils
   SineWaveGenerator<T>::SineWaveGenerator(const double frequency, const double amplitude, const bool absolute_amplitude, const double initial_phase, const unsigned int sampling_rate)
    : WaveFormGenerator<T>(sampling_rate),
      absolute_amplitude(absolute_amplitude),
-     phase(0)
+     initial_phase(fmod(initial_phase, 2 * M_PI)),
+     engine(OscillatorEngine::Direct),
+     phase(0), current_amplitude(0), generating(false)
   {
     SetAmplitude(amplitude);
     SetFrequency(frequency);
-    SetPhaseShift(initial_phase);
   }
   
   template<typename T>
@@ -38,7 +40,7 @@ namespace comutils
     if (this->frequency == 0.0)
       return 0;
     else
-      return (2 * M_PI * this->phase_shift) / this->units_per_period;
+      return this->initial_phase;
   }
   
   template<typename T>
@@ -54,42 +56,144 @@ namespace comutils
   {
     assert(frequency >= 0.0/* && frequency < this->sampling_rate / 2*/); //Uncomment if subsampling is undesired
     this->frequency = frequency;
-    this->units_per_period = this->sampling_rate / this->frequency;
   }
   
   template<typename T>
-  T SineWaveGenerator<T>::GetSample(const double selected_phase) const
+  OscillatorEngine SineWaveGenerator<T>::GetOscillatorEngine() const
   {
-    assert(selected_phase >= 0.0); //Comment this if a purely positive phase is desired
-    const double relative_amplitude = this->amplitude * (this->absolute_amplitude ? 1.0 : WaveFormGenerator<T>::max_amplitude);
-    const double current_amplitude = relative_amplitude * (this->frequency == 0 ? 1.0 : sin(2 * M_PI * this->frequency * (selected_phase + this->phase_shift) / this->sampling_rate)); //DC is multiplication with 1.0
-    const T selected_value = static_cast<T>(current_amplitude);
-    return selected_value;
+    return this->engine;
+  }
+  
+  template<typename T>
+  void SineWaveGenerator<T>::SetOscillatorEngine(const OscillatorEngine engine)
+  {
+    this->engine = engine;
+  }
+  
+  template<typename T>
+  const std::vector<double> &SineWaveGenerator<T>::GetWaveTable()
+  {
+    static const std::vector<double> table = []()
+                                                {
+                                                  std::vector<double> values(wave_table_size + 1); //The first entry is repeated at the end so that interpolation does not need to wrap around
+                                                  for (size_t i = 0; i <= wave_table_size; i++)
+                                                    values[i] = sin(2 * M_PI * i / wave_table_size);
+                                                  return values;
+                                                }();
+    return table;
+  }
+  
+  template<typename T>
+  double SineWaveGenerator<T>::GetRelativeAmplitude(const double selected_amplitude) const
+  {
+    return selected_amplitude * (this->absolute_amplitude ? 1.0 : WaveFormGenerator<T>::max_amplitude);
+  }
+  
+  template<typename T>
+  void SineWaveGenerator<T>::GetUnitSamples(const double first_phase, const double selected_frequency, const size_t N, double values[], const OscillatorEngine selected_engine) const
+  {
+    assert(first_phase >= 0.0); //Comment this if a purely positive phase is desired
+    if (selected_frequency == 0.0) //DC is multiplication with 1.0
+    {
+      std::fill_n(values, N, 1.0);
+      return;
+    }
+    const double angle_per_sample = 2 * M_PI * selected_frequency / this->sampling_rate;
+    const double first_angle = 2 * M_PI * first_phase + this->initial_phase;
+    switch (selected_engine)
+    {
+      case OscillatorEngine::Direct:
+        for (size_t i = 0; i < N; i++) //No dependencies between samples so that the loop can be vectorized
+          values[i] = sin(first_angle + angle_per_sample * i);
+        break;
+      case OscillatorEngine::Recursive:
+      {
+        const double factor = 2 * cos(angle_per_sample); //sin(x + d) = 2 * cos(d) * sin(x) - sin(x - d)
+        for (size_t start = 0; start < N; start += resynchronization_interval)
+        {
+          const size_t end = std::min(N, start + resynchronization_interval);
+          double previous_value = sin(first_angle + angle_per_sample * (start - 1.0));
+          double current_value = sin(first_angle + angle_per_sample * start);
+          for (size_t i = start; i < end; i++)
+          {
+            values[i] = current_value;
+            const double next_value = factor * current_value - previous_value;
+            previous_value = current_value;
+            current_value = next_value;
+          }
+        }
+        break;
+      }
+      case OscillatorEngine::WaveTable:
+      {
+        const auto &table = GetWaveTable();
+        const double positions_per_sample = wave_table_size * selected_frequency / this->sampling_rate;
+        double position = fmod(wave_table_size * first_angle / (2 * M_PI), wave_table_size);
+        if (position < 0) //Negative initial phases
+          position += wave_table_size;
+        if (position >= wave_table_size) //Rounding when adding to tiny negative positions
+          position -= wave_table_size;
+        const double wrapped_positions_per_sample = fmod(positions_per_sample, wave_table_size); //Frequencies above the sampling rate wrap around (aliasing)
+        for (size_t i = 0; i < N; i++)
+        {
+          const size_t index = static_cast<size_t>(position);
+          const double fraction = position - index;
+          values[i] = table[index] + fraction * (table[index + 1] - table[index]);
+          position += wrapped_positions_per_sample;
+          if (position >= wave_table_size)
+            position -= wave_table_size;
+        }
+        break;
+      }
+    }
+  }
+  
+  template<typename T>
+  void SineWaveGenerator<T>::GenerateSamples(T values[], const size_t N, const OscillatorEngine selected_engine)
+  {
+    const double selected_frequency = this->frequency; //Parameters may be changed by other threads, so they are read once per block
+    const double target_amplitude = GetRelativeAmplitude(this->amplitude);
+    if (!this->generating)
+    {
+      this->current_amplitude = target_amplitude;
+      this->generating = true;
+    }
+    unit_values.resize(N);
+    GetUnitSamples(this->phase, selected_frequency, N, unit_values.data(), selected_engine);
+    const size_t fade_length = std::min(N, static_cast<size_t>(this->sampling_rate / 100)); //10 ms to avoid clicks
+    const double amplitude_step = fade_length ? (target_amplitude - this->current_amplitude) / fade_length : 0.0;
+    for (size_t i = 0; i < fade_length; i++)
+      values[i] = static_cast<T>((this->current_amplitude + amplitude_step * (i + 1)) * unit_values[i]);
+    for (size_t i = fade_length; i < N; i++)
+      values[i] = static_cast<T>(target_amplitude * unit_values[i]);
+    this->current_amplitude = target_amplitude;
+    if (selected_frequency != 0.0) //The phase is continued with the new frequency, so that frequency changes do not cause discontinuities
+      this->phase = fmod(this->phase + N * selected_frequency / this->sampling_rate, 1.0);
   }
 
   template<typename T>
   T SineWaveGenerator<T>::GetNextSample()
   {
-    const T current_value = GetSample(this->phase);
-    if (this->frequency != 0.0)
-      this->phase = fmod(this->phase + 1, this->units_per_period);
+    T current_value;
+    GenerateSamples(&current_value, 1, OscillatorEngine::Direct);
     return current_value;
   }
   
   template<typename T>
-  void SineWaveGenerator<T>::GetRepresentativeSamples(const size_t N, T values[]) const
+  void SineWaveGenerator<T>::GenerateBlock(T values[], const size_t N)
   {
-    for (size_t i = 0; i < N; i++)
-      values[i] = GetSample(i);
+    GenerateSamples(values, N, this->engine);
   }
   
   template<typename T>
-  void SineWaveGenerator<T>::SetPhaseShift(const double initial_phase)
+  void SineWaveGenerator<T>::GetRepresentativeSamples(const size_t N, T values[]) const
   {
-    if (this->frequency != 0.0)
-    {
-      const auto simple_initial_phase = fmod(initial_phase, 2 * M_PI);
-      this->phase_shift = this->units_per_period * simple_initial_phase / (2 * M_PI);
-    }
+    std::vector<double> representative_values(N);
+    GetUnitSamples(0, this->frequency, N, representative_values.data(), OscillatorEngine::Direct);
+    const double relative_amplitude = GetRelativeAmplitude(this->amplitude);
+    std::transform(representative_values.begin(), representative_values.end(), values, [relative_amplitude](const double value)
+                                                                                                           {
+                                                                                                             return static_cast<T>(relative_amplitude * value);
+                                                                                                           });
   }
 }
@@ -0,0 +1,83 @@
+//Wave form mixer class for generators known at compile time (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "wavegen.hpp"
+#include "staticmixer.kernels.hpp"
+
+namespace comutils
+{
+  //Defines a mixer of a fixed set of wave forms whose generators are stored by value. In contrast to WaveFormMixer, the types of the generators are known at compile time so that their blocks are generated without virtual function calls and mixed in a single loop with fixed-point arithmetic. The mixing loop is dispatched at runtime (see staticmixer.kernels.hpp). It is vectorized for 8-bit and 16-bit samples, while 32-bit samples are mixed with scalar 64-bit arithmetic.
+  template<typename T, typename... Generators>
+  class StaticWaveFormMixer : public WaveFormGenerator<T>
+  {
+    static_assert(std::is_same<T, signed char>::value || std::is_same<T, short>::value || std::is_same<T, int>::value, "Only signed 8-bit, 16-bit and 32-bit samples are supported");
+    static_assert(sizeof...(Generators) > 0, "At least one generator is required");
+    static_assert((std::is_base_of<WaveFormGenerator<T>, Generators>::value && ...), "All generators must produce samples of type T");
+    public:
+      //Number of mixed generators
+      static constexpr size_t M = sizeof...(Generators);
+
+      //Constructs a new instance of StaticWaveFormMixer whose generators are constructed from one argument each, e.g., a frequency. The sampling rate is that of the generators, which all need to have the same sampling rate. The mixing factor must be between 0 and 1.
+      template<typename... Arguments>
+      StaticWaveFormMixer(const double mixing_factor, Arguments&&... arguments);
+      StaticWaveFormMixer(const StaticWaveFormMixer &original) = delete; //Explicitly delete the copy constructor since generators may be used by other threads during playback
+
+      //Returns the generator at the specified index
+      template<size_t I>
+      std::tuple_element_t<I, std::tuple<Generators...>> &GetGenerator();
+      //Calls the specified function with each generator and its index, e.g., to change the generators' parameters
+      template<typename Function>
+      void ForEachGenerator(Function function);
+      //Calls the specified function with each generator and its index (read-only access)
+      template<typename Function>
+      void ForEachGenerator(Function function) const;
+
+      //Produces the next sample of the added weighted sum of all generators. The weights are equal to the mixing factor.
+      T GetNextSample();
+      //Produces the next N samples of the added weighted sum of all generators (see above)
+      void GenerateBlock(T values[], const size_t N);
+
+      //Produces the added weighted sum of the first N representative samples of each generator
+      void GetRepresentativeSamples(const size_t N, T values[]) const;
+
+    private:
+      static constexpr int fraction_bits = sizeof(T) <= 2 ? narrow_mixing_fraction_bits : wide_mixing_fraction_bits; //Fractional bits of the fixed-point mixing factor
+
+      std::tuple<Generators...> generators;
+      const int64_t fixed_point_mixing_factor;
+      std::array<std::vector<T>, M> component_values; //Blocks of samples of all generators (reused for all blocks)
+
+      template<typename Function, size_t... I>
+      void ForEachGenerator(Function &function, std::index_sequence<I...>);
+      template<typename Function, size_t... I>
+      void ForEachGenerator(Function &function, std::index_sequence<I...>) const;
+      void MixComponents(const std::array<const T*, M> &components, const size_t N, T values[]) const;
+  };
+
+  template<typename T, typename Generator, typename Indices>
+  struct UniformWaveFormMixerType;
+
+  template<typename T, typename Generator, size_t... I>
+  struct UniformWaveFormMixerType<T, Generator, std::index_sequence<I...>>
+  {
+    template<size_t>
+    using RepeatedGenerator = Generator;
+    using Type = StaticWaveFormMixer<T, RepeatedGenerator<I>...>;
+  };
+
+  //Defines a mixer of N wave forms whose generators are all of the same type
+  template<typename T, typename Generator, size_t N>
+  using UniformWaveFormMixer = typename UniformWaveFormMixerType<T, Generator, std::make_index_sequence<N>>::Type;
+}
+
+#include "staticmixer.impl.hpp"
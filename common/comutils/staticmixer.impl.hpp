@@ -0,0 +1,118 @@
+//Wave form mixer class for generators known at compile time (template implementation)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cmath>
+
+//#include "staticmixer.hpp"
+
+namespace comutils
+{
+  template<typename T, typename... Generators>
+  template<typename... Arguments>
+  StaticWaveFormMixer<T, Generators...>::StaticWaveFormMixer(const double mixing_factor, Arguments&&... arguments)
+   : WaveFormGenerator<T>(),
+     generators(std::forward<Arguments>(arguments)...),
+     fixed_point_mixing_factor(llround(mixing_factor * (int64_t(1) << fraction_bits)))
+  {
+    assert(mixing_factor >= 0.0 && mixing_factor <= 1.0);
+    this->sampling_rate = std::get<0>(generators).GetSamplingRate();
+    ForEachGenerator([this](const WaveFormGenerator<T> &generator, const size_t)
+                                                                                {
+                                                                                  assert(generator.GetSamplingRate() == this->sampling_rate);
+                                                                                });
+  }
+
+  template<typename T, typename... Generators>
+  template<size_t I>
+  std::tuple_element_t<I, std::tuple<Generators...>> &StaticWaveFormMixer<T, Generators...>::GetGenerator()
+  {
+    return std::get<I>(generators);
+  }
+
+  template<typename T, typename... Generators>
+  template<typename Function, size_t... I>
+  void StaticWaveFormMixer<T, Generators...>::ForEachGenerator(Function &function, std::index_sequence<I...>)
+  {
+    (function(std::get<I>(generators), I), ...);
+  }
+
+  template<typename T, typename... Generators>
+  template<typename Function, size_t... I>
+  void StaticWaveFormMixer<T, Generators...>::ForEachGenerator(Function &function, std::index_sequence<I...>) const
+  {
+    (function(std::get<I>(generators), I), ...);
+  }
+
+  template<typename T, typename... Generators>
+  template<typename Function>
+  void StaticWaveFormMixer<T, Generators...>::ForEachGenerator(Function function)
+  {
+    ForEachGenerator(function, std::index_sequence_for<Generators...>());
+  }
+
+  template<typename T, typename... Generators>
+  template<typename Function>
+  void StaticWaveFormMixer<T, Generators...>::ForEachGenerator(Function function) const
+  {
+    ForEachGenerator(function, std::index_sequence_for<Generators...>());
+  }
+
+  template<typename T, typename... Generators>
+  void StaticWaveFormMixer<T, Generators...>::MixComponents(const std::array<const T*, M> &components, const size_t N, T values[]) const
+  {
+    static const MixingKernels &kernels = CPU_DISPATCH_SELECT(mixing_kernels);
+    if constexpr (std::is_same<T, signed char>::value)
+      kernels.MixSamples8(components.data(), M, N, static_cast<int32_t>(fixed_point_mixing_factor), values);
+    else if constexpr (std::is_same<T, short>::value)
+      kernels.MixSamples16(components.data(), M, N, static_cast<int32_t>(fixed_point_mixing_factor), values);
+    else
+      kernels.MixSamples32(components.data(), M, N, fixed_point_mixing_factor, values);
+  }
+
+  template<typename T, typename... Generators>
+  T StaticWaveFormMixer<T, Generators...>::GetNextSample()
+  {
+    std::array<T, M> samples;
+    ForEachGenerator([&samples](auto &generator, const size_t index)
+                                                                    {
+                                                                      using Generator = std::decay_t<decltype(generator)>;
+                                                                      samples[index] = generator.Generator::GetNextSample(); //Qualified call without virtual dispatch since the type is known
+                                                                    });
+    std::array<const T*, M> components;
+    for (size_t i = 0; i < M; i++)
+      components[i] = &samples[i];
+    T value;
+    MixComponents(components, 1, &value);
+    return value;
+  }
+
+  template<typename T, typename... Generators>
+  void StaticWaveFormMixer<T, Generators...>::GenerateBlock(T values[], const size_t N)
+  {
+    std::array<const T*, M> components;
+    ForEachGenerator([this, &components, N](auto &generator, const size_t index)
+                                                                                 {
+                                                                                   using Generator = std::decay_t<decltype(generator)>;
+                                                                                   component_values[index].resize(N);
+                                                                                   generator.Generator::GenerateBlock(component_values[index].data(), N); //Qualified call without virtual dispatch since the type is known
+                                                                                   components[index] = component_values[index].data();
+                                                                                 });
+    MixComponents(components, N, values); //One loop for all generators instead of one per generator
+  }
+
+  template<typename T, typename... Generators>
+  void StaticWaveFormMixer<T, Generators...>::GetRepresentativeSamples(const size_t N, T values[]) const
+  {
+    std::array<std::vector<T>, M> representative_samples;
+    std::array<const T*, M> components;
+    ForEachGenerator([&representative_samples, &components, N](const auto &generator, const size_t index)
+                                                                                                       {
+                                                                                                         representative_samples[index].resize(N);
+                                                                                                         generator.GetRepresentativeSamples(N, representative_samples[index].data());
+                                                                                                         components[index] = representative_samples[index].data();
+                                                                                                       });
+    MixComponents(components, N, values);
+  }
+}
@@ -0,0 +1,97 @@
+//Wave form mixer class for generators known at compile time (kernels, compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <limits>
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "staticmixer.kernels.hpp"
+
+namespace comutils
+{
+  //Mixes the remaining samples starting at the specified index (std::clamp is not used since it is not specific to the dispatch target, see cpudispatch.hpp)
+  template<typename T, int fraction_bits, typename Factor>
+  static void MixRemainingSamples(const T * const components[], const size_t M, const size_t first, const size_t N, const Factor mixing_factor, T * const values)
+  {
+    constexpr int64_t min_value = std::numeric_limits<T>::lowest();
+    constexpr int64_t max_value = std::numeric_limits<T>::max();
+    for (size_t i = first; i < N; i++)
+    {
+      int64_t sum = 0;
+      for (size_t component = 0; component < M; component++)
+        sum += (components[component][i] * static_cast<int64_t>(mixing_factor) + (int64_t(1) << (fraction_bits - 1))) >> fraction_bits;
+      values[i] = static_cast<T>(sum < min_value ? min_value : (sum > max_value ? max_value : sum));
+    }
+  }
+
+#if CV_SIMD
+  //Adds the weighted and rounded 32-bit components to the sums
+  static inline void AddWeightedComponents(const cv::v_int32 &component_values, const cv::v_int32 &mixing_factor, const cv::v_int32 &rounding_offset, cv::v_int32 &sums)
+  {
+    sums = cv::v_add(sums, cv::v_shr<narrow_mixing_fraction_bits>(cv::v_add(cv::v_mul(component_values, mixing_factor), rounding_offset))); //Same rounding as in MixRemainingSamples
+  }
+#endif
+
+  static void MixSamples8(const signed char * const components[], const size_t M, const size_t N, const int32_t mixing_factor, signed char * const values)
+  {
+    size_t i = 0;
+#if CV_SIMD
+    const size_t lanes = cv::VTraits<cv::v_int8>::vlanes();
+    const cv::v_int32 factor = cv::vx_setall_s32(mixing_factor);
+    const cv::v_int32 rounding_offset = cv::vx_setall_s32(1 << (narrow_mixing_fraction_bits - 1));
+    for (; i + lanes <= N; i += lanes)
+    {
+      cv::v_int32 sums[4] {cv::vx_setzero_s32(), cv::vx_setzero_s32(), cv::vx_setzero_s32(), cv::vx_setzero_s32()};
+      for (size_t component = 0; component < M; component++)
+      {
+        cv::v_int16 halves[2];
+        cv::v_expand(cv::vx_load(components[component] + i), halves[0], halves[1]);
+        for (size_t half = 0; half < 2; half++)
+        {
+          cv::v_int32 quarters[2];
+          cv::v_expand(halves[half], quarters[0], quarters[1]);
+          for (size_t quarter = 0; quarter < 2; quarter++)
+            AddWeightedComponents(quarters[quarter], factor, rounding_offset, sums[2 * half + quarter]);
+        }
+      }
+      cv::v_store(values + i, cv::v_pack(cv::v_pack(sums[0], sums[1]), cv::v_pack(sums[2], sums[3]))); //Saturates to the range of 8 bits
+    }
+    cv::vx_cleanup();
+#endif
+    MixRemainingSamples<signed char, narrow_mixing_fraction_bits>(components, M, i, N, mixing_factor, values);
+  }
+
+  static void MixSamples16(const short * const components[], const size_t M, const size_t N, const int32_t mixing_factor, short * const values)
+  {
+    size_t i = 0;
+#if CV_SIMD
+    const size_t lanes = cv::VTraits<cv::v_int16>::vlanes();
+    const cv::v_int32 factor = cv::vx_setall_s32(mixing_factor);
+    const cv::v_int32 rounding_offset = cv::vx_setall_s32(1 << (narrow_mixing_fraction_bits - 1));
+    for (; i + lanes <= N; i += lanes)
+    {
+      cv::v_int32 sums[2] {cv::vx_setzero_s32(), cv::vx_setzero_s32()};
+      for (size_t component = 0; component < M; component++)
+      {
+        cv::v_int32 halves[2];
+        cv::v_expand(cv::vx_load(components[component] + i), halves[0], halves[1]);
+        for (size_t half = 0; half < 2; half++)
+          AddWeightedComponents(halves[half], factor, rounding_offset, sums[half]);
+      }
+      cv::v_store(values + i, cv::v_pack(sums[0], sums[1])); //Saturates to the range of 16 bits
+    }
+    cv::vx_cleanup();
+#endif
+    MixRemainingSamples<short, narrow_mixing_fraction_bits>(components, M, i, N, mixing_factor, values);
+  }
+
+  static void MixSamples32(const int * const components[], const size_t M, const size_t N, const int64_t mixing_factor, int * const values)
+  {
+    MixRemainingSamples<int, wide_mixing_fraction_bits>(components, M, 0, N, mixing_factor, values);
+  }
+
+  const MixingKernels CPU_DISPATCH_NAME(mixing_kernels) {MixSamples8, MixSamples16, MixSamples32};
+}
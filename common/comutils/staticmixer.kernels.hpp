@@ -0,0 +1,29 @@
+//Wave form mixer class for generators known at compile time (kernels, header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpudispatch.hpp"
+
+namespace comutils
+{
+  constexpr int narrow_mixing_fraction_bits = 15; //Fractional bits of the fixed-point mixing factor for 8-bit and 16-bit samples. Weighted components fit into 32 bits before they are shifted back.
+  constexpr int wide_mixing_fraction_bits = 31; //Fractional bits of the fixed-point mixing factor for 32-bit samples. Weighted components fit into 64 bits before they are shifted back.
+
+  //Row kernels for mixing, compiled once per dispatch target (see cpudispatch.hpp). Each kernel adds the first N samples of M components, weighted with the fixed-point mixing factor and rounded per component, and saturates the sums to the range of the sample type.
+  struct MixingKernels
+  {
+    //Mixes 8-bit samples (mixing factor with narrow_mixing_fraction_bits fractional bits)
+    void (*MixSamples8)(const signed char * const components[], const size_t M, const size_t N, const int32_t mixing_factor, signed char * const values);
+    //Mixes 16-bit samples (mixing factor with narrow_mixing_fraction_bits fractional bits)
+    void (*MixSamples16)(const short * const components[], const size_t M, const size_t N, const int32_t mixing_factor, short * const values);
+    //Mixes 32-bit samples (mixing factor with wide_mixing_fraction_bits fractional bits). The products require 64 bits, for which OpenCV's intrinsics provide no portable multiplication, so this kernel is not vectorized explicitly.
+    void (*MixSamples32)(const int * const components[], const size_t M, const size_t N, const int64_t mixing_factor, int * const values);
+  };
+
+  CPU_DISPATCH_DECLARE(MixingKernels, mixing_kernels);
+}
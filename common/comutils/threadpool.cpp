@@ -0,0 +1,266 @@
+//Work-stealing thread pool with task groups
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iterator>
+#include <string>
+
+#include "trace.hpp"
+
+#include "threadpool.hpp"
+
+namespace comutils
+{
+  struct ThreadPool::Queue
+  {
+    struct Entry
+    {
+      Task task;
+      const TaskGroup *group; //Group the task belongs to, if any
+    };
+
+    std::mutex mutex;
+    std::deque<Entry> tasks;
+  };
+
+  static thread_local const ThreadPool *current_pool = nullptr; //Pool of the calling thread if it is a worker
+  static thread_local size_t current_worker_index = 0;
+
+  ThreadPool::ThreadPool(const size_t thread_count)
+   : queued_tasks(0), stopping(false)
+  {
+    const size_t worker_count = thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i <= worker_count; i++) //One additional queue for tasks submitted by other threads
+      queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < worker_count; i++)
+      workers.emplace_back(&ThreadPool::RunWorker, this, i);
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex);
+      stopping = true;
+    }
+    wake_up.notify_all();
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  size_t ThreadPool::GetThreadCount() const
+  {
+    return workers.size();
+  }
+
+  void ThreadPool::Submit(Task task, const TaskGroup * const group)
+  {
+    const size_t queue_index = current_pool == this ? current_worker_index : workers.size();
+    queued_tasks++; //Count the task before it can be popped so that the counter never wraps around below zero
+    {
+      auto &queue = *queues[queue_index];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(Queue::Entry {std::move(task), group});
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex); //Avoid missed wake-ups of workers which are about to sleep
+    }
+    wake_up.notify_one();
+  }
+
+  bool ThreadPool::TryPop(const size_t queue_index, const bool newest, const TaskGroup * const group, Task &task)
+  {
+    auto &queue = *queues[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    const auto belongs_to_group = [group](const Queue::Entry &entry)
+                                                                   {
+                                                                     return !group || entry.group == group;
+                                                                   };
+    auto entry = queue.tasks.end();
+    if (newest)
+    {
+      const auto reverse_entry = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(), belongs_to_group);
+      if (reverse_entry != queue.tasks.rend())
+        entry = std::prev(reverse_entry.base());
+    }
+    else
+      entry = std::find_if(queue.tasks.begin(), queue.tasks.end(), belongs_to_group);
+    if (entry == queue.tasks.end())
+      return false;
+    task = std::move(entry->task);
+    queue.tasks.erase(entry); //Only tasks of other groups are skipped, so this is the front or back of the queue in most cases
+    queued_tasks--;
+    return true;
+  }
+
+  bool ThreadPool::RunPendingTask(const TaskGroup * const group)
+  {
+    if (!queued_tasks)
+      return false;
+    Task task;
+    const bool is_worker = current_pool == this;
+    const size_t own_index = is_worker ? current_worker_index : workers.size();
+    bool found = TryPop(own_index, is_worker, group, task); //Own tasks first (newest first for workers since their data is most likely still in the cache)
+    for (size_t offset = 1; !found && offset < queues.size(); offset++) //Steal the oldest tasks of the other queues, starting with the next one so that not all thieves start at the same queue
+      found = TryPop((own_index + offset) % queues.size(), false, group, task);
+    if (!found)
+      return false;
+    task();
+    return true;
+  }
+
+  void ThreadPool::RunWorker(const size_t worker_index)
+  {
+    current_pool = this;
+    current_worker_index = worker_index;
+    if (TraceScope::IsEnabled())
+      TraceScope::SetThreadName(("Worker " + std::to_string(worker_index)).c_str());
+    while (true)
+    {
+      if (RunPendingTask())
+        continue;
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      wake_up.wait(lock, [this]()
+                               {
+                                 return stopping || queued_tasks;
+                               });
+      if (stopping && !queued_tasks)
+        break;
+    }
+  }
+
+  ThreadPool &ThreadPool::GetDefault()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  TaskGroup::TaskGroup(ThreadPool &pool)
+   : pool(pool), pending_tasks(0), cancelled(false) { }
+
+  TaskGroup::~TaskGroup()
+  {
+    if (pending_tasks)
+      Cancel();
+    try
+    {
+      Wait(); //Also makes sure that the last task has released the mutex
+    }
+    catch (...) { } //Exceptions cannot be reported from a destructor
+  }
+
+  void TaskGroup::Run(ThreadPool::Task task)
+  {
+    pending_tasks++;
+    pool.Submit([this, task = std::move(task)]()
+                                               {
+                                                 if (!cancelled)
+                                                 {
+                                                   try
+                                                   {
+                                                     task();
+                                                   }
+                                                   catch (...)
+                                                   {
+                                                     std::lock_guard<std::mutex> lock(mutex);
+                                                     if (!exception)
+                                                       exception = std::current_exception();
+                                                     cancelled = true;
+                                                   }
+                                                 }
+                                                 std::lock_guard<std::mutex> lock(mutex); //The group may be destroyed as soon as the last task has finished, so notify while holding the lock
+                                                 if (!--pending_tasks)
+                                                   finished.notify_all();
+                                               }, this);
+  }
+
+  void TaskGroup::Wait()
+  {
+    constexpr auto poll_interval = std::chrono::milliseconds(1); //Interval in which waiting threads check for new tasks to help with, e.g., tasks submitted by running tasks
+    while (pending_tasks)
+    {
+      if (pool.RunPendingTask(this)) //Only help with tasks of this group, e.g., so that a nested ParallelFor within a task does not start unrelated tasks of the outer group
+        continue;
+      std::unique_lock<std::mutex> lock(mutex);
+      finished.wait_for(lock, poll_interval, [this]()
+                                                   {
+                                                     return !pending_tasks;
+                                                   });
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (exception)
+    {
+      const auto first_exception = exception;
+      exception = nullptr;
+      std::rethrow_exception(first_exception);
+    }
+  }
+
+  void TaskGroup::Cancel()
+  {
+    cancelled = true;
+  }
+
+  bool TaskGroup::IsCancelled() const
+  {
+    return cancelled;
+  }
+
+  void ParallelFor(TaskGroup &group, const size_t count, const size_t grain_size, const std::function<void(size_t, size_t)> &function)
+  {
+    assert(grain_size > 0);
+    if (count <= grain_size) //Avoid the overhead of tasks when there is nothing to split
+    {
+      if (count && !group.IsCancelled())
+        function(0, count);
+      return;
+    }
+    for (size_t begin = 0; begin < count; begin += grain_size)
+    {
+      const size_t end = std::min(count, begin + grain_size);
+      group.Run([&function, begin, end]()
+                                      {
+                                        function(begin, end);
+                                      });
+    }
+    group.Wait();
+  }
+
+  void ParallelFor(const size_t count, const size_t grain_size, const std::function<void(size_t, size_t)> &function)
+  {
+    TaskGroup group;
+    ParallelFor(group, count, grain_size, function);
+  }
+
+  void ParallelFor2D(TaskGroup &group, const size_t width, const size_t height, const size_t tile_width, const size_t tile_height, const std::function<void(const Tile&)> &function)
+  {
+    assert(tile_width > 0 && tile_height > 0);
+    if (width <= tile_width && height <= tile_height) //Avoid the overhead of tasks when there is nothing to split
+    {
+      if (width && height && !group.IsCancelled())
+        function(Tile {0, 0, width, height});
+      return;
+    }
+    for (size_t y = 0; y < height; y += tile_height)
+    {
+      for (size_t x = 0; x < width; x += tile_width)
+      {
+        const Tile tile {x, y, std::min(tile_width, width - x), std::min(tile_height, height - y)};
+        group.Run([&function, tile]()
+                                  {
+                                    function(tile);
+                                  });
+      }
+    }
+    group.Wait();
+  }
+
+  void ParallelFor2D(const size_t width, const size_t height, const size_t tile_width, const size_t tile_height, const std::function<void(const Tile&)> &function)
+  {
+    TaskGroup group;
+    ParallelFor2D(group, width, height, tile_width, tile_height, function);
+  }
+}
@@ -0,0 +1,103 @@
+//Work-stealing thread pool with task groups (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace comutils
+{
+  class TaskGroup; //See below
+
+  //Pool of worker threads with one task queue each. Workers execute the tasks of their own queue in LIFO order and steal tasks from the other queues in FIFO order when they run out of work.
+  class ThreadPool
+  {
+    public:
+      using Task = std::function<void()>;
+
+      //Starts the specified number of worker threads (zero means one per hardware thread)
+      ThreadPool(const size_t thread_count = 0);
+      ThreadPool(const ThreadPool &original) = delete; //Explicitly delete the copy constructor since the workers belong to one pool
+      //Executes all remaining tasks and stops the worker threads
+      ~ThreadPool();
+
+      //Returns the number of worker threads
+      size_t GetThreadCount() const;
+
+      //Queues a task for execution. Tasks submitted by a worker are put into its own queue. The task must not throw (see TaskGroup for tasks which may throw). The task may be tagged with the group it belongs to (see RunPendingTask).
+      void Submit(Task task, const TaskGroup * const group = nullptr);
+      //Executes one queued task on the calling thread, if there is one, and returns whether a task was executed. This allows threads which wait for tasks to help instead of blocking workers. If a group is specified, only tasks of this group are executed so that a waiting thread does not get stuck in unrelated (long) tasks and the nesting depth is bounded.
+      bool RunPendingTask(const TaskGroup * const group = nullptr);
+
+      //Returns the pool shared by all users which do not specify one themselves
+      static ThreadPool &GetDefault();
+
+    private:
+      struct Queue;
+
+      std::vector<std::unique_ptr<Queue>> queues; //One per worker plus one for tasks submitted by other threads (last)
+      std::vector<std::thread> workers;
+      std::atomic<size_t> queued_tasks;
+      std::mutex sleep_mutex;
+      std::condition_variable wake_up;
+      bool stopping;
+
+      bool TryPop(const size_t queue_index, const bool newest, const TaskGroup * const group, Task &task);
+      void RunWorker(const size_t worker_index);
+  };
+
+  //Group of tasks executed by a thread pool which can be waited for and cancelled together. Exceptions thrown by tasks cancel the group and are rethrown by Wait.
+  class TaskGroup
+  {
+    public:
+      //Creates an empty group whose tasks are executed by the specified pool
+      TaskGroup(ThreadPool &pool = ThreadPool::GetDefault());
+      TaskGroup(const TaskGroup &original) = delete; //Explicitly delete the copy constructor since queued tasks refer to the group
+      //Cancels the group if it has not been waited for and waits for all started tasks
+      ~TaskGroup();
+
+      //Queues a task. It is skipped if the group is cancelled before it is started.
+      void Run(ThreadPool::Task task);
+      //Waits for all tasks, helping to execute queued tasks of this group in the meantime, and rethrows the first exception thrown by a task, if any
+      void Wait();
+      //Skips all tasks of the group which have not been started yet. Running tasks can check IsCancelled to abort early.
+      void Cancel();
+      //Returns whether the group has been cancelled
+      bool IsCancelled() const;
+
+    private:
+      ThreadPool &pool;
+      std::atomic<size_t> pending_tasks;
+      std::atomic_bool cancelled;
+      std::mutex mutex;
+      std::condition_variable finished;
+      std::exception_ptr exception;
+  };
+
+  //Rectangular part of a 2-D range
+  struct Tile
+  {
+    size_t x;
+    size_t y;
+    size_t width;
+    size_t height;
+  };
+
+  //Splits the range [0;count) into consecutive parts of at most grain_size elements and executes function(begin, end) for each of them as tasks of the specified group and waits for the group. Ranges which fit into one part are processed directly on the calling thread.
+  void ParallelFor(TaskGroup &group, const size_t count, const size_t grain_size, const std::function<void(size_t, size_t)> &function);
+  //Same as above with a temporary group on the default pool
+  void ParallelFor(const size_t count, const size_t grain_size, const std::function<void(size_t, size_t)> &function);
+  //Splits a 2-D range of the specified width and height into tiles of at most the specified tile size and executes function(tile) for each of them as tasks of the specified group and waits for the group. Ranges which fit into one tile are processed directly on the calling thread.
+  void ParallelFor2D(TaskGroup &group, const size_t width, const size_t height, const size_t tile_width, const size_t tile_height, const std::function<void(const Tile&)> &function);
+  //Same as above with a temporary group on the default pool
+  void ParallelFor2D(const size_t width, const size_t height, const size_t tile_width, const size_t tile_height, const std::function<void(const Tile&)> &function);
+}
@@ -0,0 +1,200 @@
+//Scoped tracing with Chrome trace-event output
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace comutils
+{
+  struct TraceEvent
+  {
+    const char *name;
+    int64_t start_time;
+    int64_t duration;
+  };
+
+  //Writes a string as JSON string literal, escaping quotes and backslashes (names do not contain control characters)
+  static void WriteJSONString(std::ostream &stream, const char *string)
+  {
+    stream << '"';
+    for (; *string; string++)
+    {
+      if (*string == '"' || *string == '\\')
+        stream << '\\';
+      stream << *string;
+    }
+    stream << '"';
+  }
+
+  //Events of one thread. Only the owning thread writes; the events are only read on exit. Published events are never modified, so the number of events is the only synchronization required. The name is protected by the registry's mutex.
+  class ThreadTraceBuffer
+  {
+    public:
+      ThreadTraceBuffer(const size_t id)
+       : id(id), event_count(0), dropped_event_count(0), name("Thread " + std::to_string(id))
+      {
+        for (auto &chunk : chunks)
+          chunk.store(nullptr, std::memory_order_relaxed);
+      }
+
+      void Add(const TraceEvent &event)
+      {
+        const size_t count = event_count.load(std::memory_order_relaxed);
+        const size_t chunk_index = count / chunk_size;
+        if (chunk_index >= max_chunks)
+        {
+          dropped_event_count.fetch_add(1, std::memory_order_relaxed); //Only counted, so no ordering is required
+          return;
+        }
+        TraceEvent *chunk = chunks[chunk_index].load(std::memory_order_relaxed);
+        if (!chunk) //Chunks are only allocated when needed, so that threads with few events do not waste memory
+        {
+          chunk = new TraceEvent[chunk_size];
+          chunks[chunk_index].store(chunk, std::memory_order_relaxed);
+        }
+        chunk[count % chunk_size] = event;
+        event_count.store(count + 1, std::memory_order_release); //Publish the event (and the chunk)
+      }
+
+      void Write(std::ostream &stream, bool &first) const
+      {
+        stream << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << id << R"(,"args":{"name":)";
+        WriteJSONString(stream, name.c_str());
+        stream << "}}";
+        first = false;
+        const size_t count = event_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++)
+        {
+          const TraceEvent &event = chunks[i / chunk_size].load(std::memory_order_relaxed)[i % chunk_size];
+          stream << ",\n" << R"({"name":)";
+          WriteJSONString(stream, event.name);
+          stream << R"(,"ph":"X","pid":1,"tid":)" << id
+                 << R"(,"ts":)" << event.start_time / 1000.0 << R"(,"dur":)" << event.duration / 1000.0 << "}"; //Microseconds
+        }
+        const size_t dropped_count = dropped_event_count.load(std::memory_order_relaxed);
+        if (dropped_count)
+          std::cerr << "Dropped " << dropped_count << " trace events of thread '" << name << "' since its buffer was full" << std::endl;
+      }
+
+      //Requires the registry's mutex to be locked since the name may be read on exit while the thread is still running
+      void SetName(const char * const name)
+      {
+        this->name = name;
+      }
+
+    private:
+      static constexpr size_t chunk_size = 1 << 14;
+      static constexpr size_t max_chunks = 1 << 8; //At most 4M events per thread
+
+      const size_t id;
+      std::atomic<TraceEvent*> chunks[max_chunks];
+      std::atomic<size_t> event_count;
+      std::atomic<size_t> dropped_event_count;
+      std::string name;
+  };
+
+  //All thread buffers. They are never freed since threads may still record events while the trace is written on exit.
+  struct TraceRegistry
+  {
+    std::mutex mutex;
+    std::vector<ThreadTraceBuffer*> buffers;
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    const char * const filename;
+
+    TraceRegistry(const char * const filename)
+     : filename(filename) { }
+  };
+
+  static TraceRegistry *GetRegistry();
+
+  static void WriteTrace()
+  {
+    TraceRegistry &registry = *GetRegistry();
+    std::ofstream trace_file(registry.filename);
+    if (!trace_file)
+    {
+      std::cerr << "Could not write trace to '" << registry.filename << "'" << std::endl;
+      return;
+    }
+    trace_file << std::fixed << std::setprecision(3);
+    trace_file << R"({"displayTimeUnit":"ms","traceEvents":[)" << std::endl;
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto buffer : registry.buffers)
+      buffer->Write(trace_file, first);
+    trace_file << std::endl << "]}" << std::endl;
+  }
+
+  //Returns the registry if tracing is enabled and nullptr otherwise
+  static TraceRegistry *GetRegistry()
+  {
+    static TraceRegistry * const registry = []() -> TraceRegistry*
+                                                  {
+                                                    const char * const filename = std::getenv("TRACE_FILE");
+                                                    if (!filename || !*filename)
+                                                      return nullptr;
+                                                    const auto registry = new TraceRegistry(filename);
+                                                    std::atexit(WriteTrace);
+                                                    return registry;
+                                                  }();
+    return registry;
+  }
+
+  static int64_t GetTraceTime(const TraceRegistry &registry)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - registry.start_time).count();
+  }
+
+  static ThreadTraceBuffer &GetThreadBuffer(TraceRegistry &registry)
+  {
+    static thread_local ThreadTraceBuffer *buffer = nullptr;
+    if (!buffer)
+    {
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      buffer = new ThreadTraceBuffer(registry.buffers.size() + 1); //Thread IDs start at 1
+      registry.buffers.push_back(buffer);
+    }
+    return *buffer;
+  }
+
+  TraceScope::TraceScope(const char * const name)
+   : name(name)
+  {
+    const TraceRegistry * const registry = GetRegistry();
+    start_time = registry ? GetTraceTime(*registry) : 0;
+  }
+
+  TraceScope::~TraceScope()
+  {
+    TraceRegistry * const registry = GetRegistry();
+    if (!registry)
+      return;
+    const int64_t end_time = GetTraceTime(*registry);
+    GetThreadBuffer(*registry).Add(TraceEvent {name, start_time, end_time - start_time});
+  }
+
+  bool TraceScope::IsEnabled()
+  {
+    return GetRegistry() != nullptr;
+  }
+
+  void TraceScope::SetThreadName(const char * const name)
+  {
+    TraceRegistry * const registry = GetRegistry();
+    if (!registry)
+      return;
+    ThreadTraceBuffer &buffer = GetThreadBuffer(*registry);
+    std::lock_guard<std::mutex> lock(registry->mutex);
+    buffer.SetName(name);
+  }
+}
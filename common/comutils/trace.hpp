@@ -0,0 +1,31 @@
+//Scoped tracing with Chrome trace-event output (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstdint>
+
+namespace comutils
+{
+  //Records the time between its construction and destruction as an event of the calling thread if tracing is enabled. Tracing is enabled by setting the environment variable TRACE_FILE to the path of a file to which all events are written in the Chrome trace-event format (JSON) on exit. The file can be viewed with Perfetto or chrome://tracing.
+  //Events are recorded into per-thread buffers without locking, so that scopes can be used in hot paths. When tracing is disabled, scopes do nothing apart from checking whether tracing is enabled.
+  class TraceScope
+  {
+    public:
+      //Starts an event with the specified name. The name needs to remain valid until the program exits, e.g., by being a string literal.
+      TraceScope(const char * const name);
+      TraceScope(const TraceScope &original) = delete; //Explicitly delete the copy constructor since the event would be recorded twice
+      //Ends the event and records it
+      ~TraceScope();
+
+      //Returns whether tracing is enabled (see above)
+      static bool IsEnabled();
+      //Sets the name of the calling thread as it appears in the trace. The name is copied. It may be changed at any time, even while the trace is being written on exit.
+      static void SetThreadName(const char * const name);
+
+    private:
+      const char * const name;
+      int64_t start_time; //In nanoseconds since the start of tracing
+  };
+}
@@ -1,10 +1,11 @@
 //Wave form generator interface (header)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
 
 #include <cstddef>
+#include <limits>
 
 namespace comutils
 {
@@ -18,6 +19,8 @@ namespace comutils
       
       //Produces the next sample of the wave form. To be implemented in child classes.
       virtual T GetNextSample() = 0;
+      //Produces the next N samples of the wave form. The default implementation calls GetNextSample N times, so child classes should override it with a more efficient implementation.
+      virtual void GenerateBlock(T values[], const size_t N);
       
       //Produces N representative samples of the wave form. To be implemented in child classes.
       virtual void GetRepresentativeSamples(const size_t N, T values[]) const = 0;
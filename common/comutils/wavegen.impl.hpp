@@ -1,5 +1,5 @@
 //Wave form generator interface (template implementation)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <cassert>
@@ -14,6 +14,13 @@ namespace comutils
     assert(sampling_rate > 0);
   }
 
+  template<typename T>
+  void WaveFormGenerator<T>::GenerateBlock(T values[], const size_t N)
+  {
+    for (size_t i = 0; i < N; i++)
+      values[i] = GetNextSample();
+  }
+
   template<typename T>
   unsigned int WaveFormGenerator<T>::GetSamplingRate() const
   {
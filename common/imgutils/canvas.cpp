@@ -0,0 +1,126 @@
+//Image canvas with a fixed tile layout
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <algorithm>
+
+#include <opencv2/imgproc.hpp>
+
+#include "trace.hpp"
+
+#include "canvas.hpp"
+
+namespace imgutils
+{
+  Canvas::Canvas()
+   : columns(0),
+     rows(0),
+     border_size(0) { }
+
+  Canvas::Canvas(const cv::Size &tile_size, const int columns, const int rows, const unsigned int border_size, const int type)
+   : Canvas()
+  {
+    Create(tile_size, columns, rows, border_size, type);
+  }
+
+  Canvas::Canvas(const cv::Size &tile_size, const size_t N, const CombinationMode mode, const unsigned int border_size, const int type)
+   : Canvas(tile_size, mode == CombinationMode::Horizontal ? static_cast<int>(N) : 1, mode == CombinationMode::Horizontal ? 1 : static_cast<int>(N), border_size, type) { }
+
+  void Canvas::Create(const cv::Size &tile_size, const int columns, const int rows, const unsigned int border_size, const int type)
+  {
+    assert(tile_size.width > 0 && tile_size.height > 0);
+    assert(columns > 0 && rows > 0);
+    assert(type == CV_8UC1 || type == CV_8UC3);
+    this->tile_size = tile_size;
+    this->columns = columns;
+    this->rows = rows;
+    this->border_size = static_cast<int>(border_size);
+    const cv::Size size(columns * tile_size.width + (columns - 1) * this->border_size, rows * tile_size.height + (rows - 1) * this->border_size);
+    image.create(size, type); //Only reallocates if necessary
+    image.setTo(cv::Scalar::all(0)); //Black tiles and borders
+    content_sizes.assign(GetTileCount(), cv::Size()); //Nothing has been copied into the tiles yet
+  }
+
+  bool Canvas::IsEmpty() const
+  {
+    return image.empty();
+  }
+
+  cv::Size Canvas::GetTileSize() const
+  {
+    return tile_size;
+  }
+
+  int Canvas::GetColumns() const
+  {
+    return columns;
+  }
+
+  int Canvas::GetRows() const
+  {
+    return rows;
+  }
+
+  size_t Canvas::GetTileCount() const
+  {
+    return static_cast<size_t>(columns) * rows;
+  }
+
+  unsigned int Canvas::GetBorderSize() const
+  {
+    return static_cast<unsigned int>(border_size);
+  }
+
+  int Canvas::GetType() const
+  {
+    return image.type();
+  }
+
+  cv::Rect Canvas::GetTileRect(const int column, const int row) const
+  {
+    assert(column >= 0 && column < columns);
+    assert(row >= 0 && row < rows);
+    return cv::Rect(column * (tile_size.width + border_size), row * (tile_size.height + border_size), tile_size.width, tile_size.height);
+  }
+
+  cv::Mat Canvas::GetTile(const int column, const int row) const
+  {
+    return image(GetTileRect(column, row));
+  }
+
+  cv::Mat Canvas::GetTile(const size_t index) const
+  {
+    assert(index < GetTileCount());
+    return GetTile(static_cast<int>(index % columns), static_cast<int>(index / columns));
+  }
+
+  void Canvas::UpdateTile(const size_t index, const cv::Mat &image)
+  {
+    const comutils::TraceScope trace_scope("Canvas::UpdateTile");
+    assert(image.type() == CV_8UC1 || image.type() == this->image.type());
+    assert(image.cols <= tile_size.width && image.rows <= tile_size.height);
+    cv::Mat tile = GetTile(index);
+    auto &content_size = content_sizes[index];
+    if (image.data == tile.data && image.step == tile.step) //Already rendered into the tile
+    {
+      content_size = image.size();
+      return;
+    }
+    cv::Mat content = tile(cv::Rect(cv::Point(), image.size()));
+    if (image.type() == content.type())
+      image.copyTo(content); //Does not reallocate since the sizes and types match
+    else
+      cv::cvtColor(image, content, cv::COLOR_GRAY2BGR); //Convert directly into the tile
+    if (content_size.width > image.cols) //Clear the remainder of a previously larger image
+      tile(cv::Rect(image.cols, 0, content_size.width - image.cols, content_size.height)).setTo(cv::Scalar::all(0));
+    if (content_size.height > image.rows)
+      tile(cv::Rect(0, image.rows, std::min(content_size.width, image.cols), content_size.height - image.rows)).setTo(cv::Scalar::all(0));
+    content_size = image.size();
+  }
+
+  const cv::Mat &Canvas::GetImage() const
+  {
+    return image;
+  }
+}
@@ -0,0 +1,66 @@
+//Image canvas with a fixed tile layout (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "combine.hpp"
+
+namespace imgutils
+{
+  //Persistent 8-bit image with a fixed grid of equally sized tiles which are separated by black borders. Tiles are accessible as matrix headers so that images can be rendered into them directly. Nothing is allocated after the canvas has been created.
+  class Canvas
+  {
+    public:
+      //Creates an empty canvas
+      Canvas();
+      //Creates a canvas with the specified number of tile columns and rows of the specified tile size and type (8-bit gray-scale or BGR), separated by black borders of the specified width. All tiles are black initially.
+      Canvas(const cv::Size &tile_size, const int columns, const int rows = 1, const unsigned int border_size = 3, const int type = CV_8UC3);
+      //Creates a canvas with N tiles of the specified size and type next to (horizontal) or below (vertical) each other, separated by black borders of the specified width
+      Canvas(const cv::Size &tile_size, const size_t N, const CombinationMode mode, const unsigned int border_size = 3, const int type = CV_8UC3);
+
+      //Changes the layout of the canvas. The memory is only reallocated if the size or type of the canvas changes. All tiles are black afterwards.
+      void Create(const cv::Size &tile_size, const int columns, const int rows = 1, const unsigned int border_size = 3, const int type = CV_8UC3);
+
+      //Returns true if the canvas has no tiles
+      bool IsEmpty() const;
+      //Returns the size of each tile
+      cv::Size GetTileSize() const;
+      //Returns the number of tiles per row
+      int GetColumns() const;
+      //Returns the number of tiles per column
+      int GetRows() const;
+      //Returns the total number of tiles
+      size_t GetTileCount() const;
+      //Returns the width of the borders between tiles
+      unsigned int GetBorderSize() const;
+      //Returns the type of the canvas (8-bit gray-scale or BGR)
+      int GetType() const;
+
+      //Returns the position and size of the tile at the specified column and row within the canvas
+      cv::Rect GetTileRect(const int column, const int row) const;
+      //Returns a matrix header of the tile at the specified column and row. Writing into it changes the canvas.
+      cv::Mat GetTile(const int column, const int row) const;
+      //Returns a matrix header of the tile with the specified index (counted row by row). Writing into it changes the canvas.
+      cv::Mat GetTile(const size_t index) const;
+
+      //Copies an 8-bit gray-scale or BGR image into the tile with the specified index (counted row by row), converting gray-scale images to BGR if required. Images which are smaller than the tile are placed in its top-left corner with black borders. Images which are already (rendered into) the tile are not copied. Other tiles remain untouched.
+      void UpdateTile(const size_t index, const cv::Mat &image);
+
+      //Returns the whole canvas, e.g., for displaying it
+      const cv::Mat &GetImage() const;
+
+    private:
+      cv::Mat image;
+      cv::Size tile_size;
+      int columns;
+      int rows;
+      int border_size;
+      std::vector<cv::Size> content_sizes; //Size of the last image copied into each tile
+  };
+}
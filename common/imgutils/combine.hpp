@@ -1,5 +1,5 @@
 //Image combination functions (header)
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
@@ -13,6 +13,8 @@ namespace imgutils
   //Position of combined images
   enum class CombinationMode { Horizontal, Vertical };
 
+  class Canvas; //See canvas.hpp
+
   //Method to convert difference images
   enum class DifferenceConversionMode
   {
@@ -28,11 +30,20 @@ namespace imgutils
   //Concatenates N images (of potentially different sizes and color spaces) horizontally or vertically with black borders between them. If the images differ in size, they are border-filled to the largest width and height across all images.
   cv::Mat CombineImages(const size_t N, const cv::Mat images[], const CombinationMode mode, const unsigned int border_size = 3);
 
+  //Concatenates N images like CombineImages above, but renders them into the specified canvas and returns its image. The canvas is only recreated if the combined layout changes, e.g., when the image sizes change, so that nothing is allocated when the same layout is combined repeatedly.
+  template<size_t N>
+  const cv::Mat &CombineImages(const cv::Mat (&images)[N], Canvas &canvas, const CombinationMode mode, const unsigned int border_size = 3);
+
+  //Concatenates N images like CombineImages above, but renders them into the specified canvas and returns its image (see above)
+  const cv::Mat &CombineImages(const size_t N, const cv::Mat images[], Canvas &canvas, const CombinationMode mode, const unsigned int border_size = 3);
+
   //Subtracts two (unsigned) 8-bit images from one another and returns a (signed) 16-bit difference image
   cv::Mat SubtractImages(const cv::Mat &image1, const cv::Mat &image2);
 
   //Converts a difference image (with one channel of signed 16-bit values) to illustrate it as an unsigned 8-bit image, e.g., with imshow
   cv::Mat ConvertDifferenceImage(const cv::Mat &difference_image, DifferenceConversionMode mode = DifferenceConversionMode::Color);
+  //Converts a difference image (with one channel of signed 16-bit values) to illustrate it as an unsigned 8-bit image, e.g., with imshow. The converted image is (re)allocated only if its size or type does not match.
+  void ConvertDifferenceImage(const cv::Mat &difference_image, cv::Mat &converted_image, DifferenceConversionMode mode = DifferenceConversionMode::Color);
 }
 
 #include "combine.impl.hpp"
@@ -1,5 +1,5 @@
 //Image combination functions (template implementations)
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include "common.hpp"
@@ -13,4 +13,10 @@ namespace imgutils
   {
 	  return CombineImages(N, images, mode, border_size);
   }
+
+  template<size_t N>
+  const cv::Mat &CombineImages(const cv::Mat (&images)[N], Canvas &canvas, const CombinationMode mode, const unsigned int border_size) //Comfort version for initializer lists (no need to explicitly specify N)
+  {
+    return CombineImages(N, images, canvas, mode, border_size);
+  }
 }
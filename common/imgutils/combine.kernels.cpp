@@ -0,0 +1,67 @@
+//Difference image conversion kernels (compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "combine.kernels.hpp"
+
+namespace imgutils
+{
+  //Returns the absolute value of a difference, saturated to 255 (std::abs and std::min are not used since they are not specific to the dispatch target, see cpudispatch.hpp)
+  static inline unsigned char GetSaturatedAbsoluteValue(const short value)
+  {
+    const int absolute_value = value < 0 ? -value : value;
+    return static_cast<unsigned char>(absolute_value > 255 ? 255 : absolute_value);
+  }
+
+  static void ConvertAbsoluteDifferenceRow(const short * const differences, unsigned char * const converted, const int width)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes_16 = cv::VTraits<cv::v_int16>::vlanes();
+    for (; x <= width - lanes; x += lanes)
+    {
+      const cv::v_uint16 absolute_values[] {cv::v_abs(cv::vx_load(differences + x)), cv::v_abs(cv::vx_load(differences + x + lanes_16))};
+      cv::v_store(converted + x, cv::v_pack(absolute_values[0], absolute_values[1])); //Saturates at 255
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+      converted[x] = GetSaturatedAbsoluteValue(differences[x]);
+  }
+
+  static void ConvertColorDifferenceRow(const short * const differences, unsigned char * const converted, const int width)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes_16 = cv::VTraits<cv::v_int16>::vlanes();
+    const cv::v_int16 zero_16 = cv::vx_setzero_s16();
+    const cv::v_uint8 zero = cv::vx_setzero_u8();
+    for (; x <= width - lanes; x += lanes)
+    {
+      const cv::v_int16 values[] {cv::vx_load(differences + x), cv::vx_load(differences + x + lanes_16)};
+      const cv::v_uint8 absolute_values = cv::v_pack(cv::v_abs(values[0]), cv::v_abs(values[1])); //Saturates at 255
+      const cv::v_uint8 negative = cv::v_reinterpret_as_u8(cv::v_pack(cv::v_lt(values[0], zero_16), cv::v_lt(values[1], zero_16))); //All bits set for negative values
+      const cv::v_uint8 positive = cv::v_reinterpret_as_u8(cv::v_pack(cv::v_gt(values[0], zero_16), cv::v_gt(values[1], zero_16))); //All bits set for positive values
+      cv::v_store_interleave(converted + 3 * x, cv::v_select(negative, absolute_values, zero), absolute_values, cv::v_select(positive, absolute_values, zero));
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+    {
+      const short value = differences[x];
+      const unsigned char absolute_value = GetSaturatedAbsoluteValue(value);
+      unsigned char * const pixel = converted + 3 * x;
+      pixel[0] = value < 0 ? absolute_value : 0; //BGR order
+      pixel[1] = absolute_value;
+      pixel[2] = value > 0 ? absolute_value : 0;
+    }
+  }
+
+  const DifferenceConversionKernels CPU_DISPATCH_NAME(difference_conversion_kernels) {ConvertAbsoluteDifferenceRow, ConvertColorDifferenceRow};
+}
@@ -0,0 +1,21 @@
+//Difference image conversion kernels (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include "cpudispatch.hpp"
+
+namespace imgutils
+{
+  //Row kernels for converting difference images, compiled once per dispatch target (see cpudispatch.hpp). Kernels do not use OpenCV types so that only the intrinsics are compiled with the instruction sets of the target.
+  struct DifferenceConversionKernels
+  {
+    //Converts one row of 16-bit differences into their 8-bit absolute values (saturated to 255)
+    void (*ConvertAbsoluteDifferenceRow)(const short * const differences, unsigned char * const converted, const int width);
+    //Converts one row of 16-bit differences into BGR pixels, i.e., blue for negative differences, red for positive differences and green always to make pixels brighter
+    void (*ConvertColorDifferenceRow)(const short * const differences, unsigned char * const converted, const int width);
+  };
+
+  CPU_DISPATCH_DECLARE(DifferenceConversionKernels, difference_conversion_kernels);
+}
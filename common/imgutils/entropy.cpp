@@ -0,0 +1,222 @@
+//Entropy coding functions for transform coefficients
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cstdlib>
+#include <array>
+#include <algorithm>
+
+#include "common.hpp"
+
+#include "entropy.hpp"
+
+namespace imgutils
+{
+  std::vector<CoefficientIndex> ZigZagScanIndices(const unsigned int block_size)
+  {
+    assert(block_size >= 1);
+    size_t x = 0, y = 0;
+    bool up = true;
+    std::vector<CoefficientIndex> indices;
+    indices.reserve(block_size * block_size);
+    indices.push_back(CoefficientIndex(0, 0));
+    while (!(x == block_size - 1 && y == block_size - 1))
+    {
+      while(up)
+      {
+        if (y == 0 || x == block_size - 1)
+        {
+          if (y == 0)
+            x++;
+          else if (x == block_size - 1)
+            y++;
+          indices.push_back(CoefficientIndex(x, y));
+          up = false;
+        }
+        else
+        {
+          x++;
+          y--;
+          indices.push_back(CoefficientIndex(x, y));
+        }
+      }
+      while (!up)
+      {
+        if (x == 0 || y == block_size - 1)
+        {
+          if (y == block_size - 1)
+            x++;
+          else if (x == 0)
+            y++;
+          indices.push_back(CoefficientIndex(x, y));
+          up = true;
+        }
+        else
+        {
+          x--;
+          y++;
+          indices.push_back(CoefficientIndex(x, y));
+        }
+      }
+    }
+    return indices;
+  }
+
+  //Code words and their lengths for all 256 possible symbols (zero length means that the symbol cannot be coded)
+  struct HuffmanTable
+  {
+    std::array<uint16_t, 256> codes;
+    std::array<unsigned char, 256> lengths;
+  };
+
+  //Size category (number of significant bits) of each magnitude up to the largest DC difference
+  using CategoryTable = std::array<unsigned char, 2048>;
+
+  //Derives canonical Huffman codes from the number of codes per length and the symbols in order of increasing code length (see ITU-T T.81, Annex C)
+  template<size_t N>
+  static HuffmanTable BuildHuffmanTable(const unsigned char (&bits)[16], const unsigned char (&symbols)[N])
+  {
+    HuffmanTable table = {};
+    uint16_t code = 0;
+    size_t k = 0;
+    for (unsigned int length = 1; length <= comutils::arraysize(bits); length++)
+    {
+      for (unsigned int i = 0; i < bits[length - 1]; i++, k++)
+      {
+        assert(k < N);
+        table.codes[symbols[k]] = code++;
+        table.lengths[symbols[k]] = length;
+      }
+      code <<= 1;
+    }
+    assert(k == N);
+    return table;
+  }
+
+  static const HuffmanTable &GetDCTable()
+  {
+    //Standard luminance DC table (ITU-T T.81, Table K.3)
+    static constexpr unsigned char bits[] {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+    static constexpr unsigned char symbols[] {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    static const HuffmanTable table = BuildHuffmanTable(bits, symbols);
+    return table;
+  }
+
+  static const HuffmanTable &GetACTable()
+  {
+    //Standard luminance AC table (ITU-T T.81, Table K.5)
+    static constexpr unsigned char bits[] {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D};
+    static constexpr unsigned char symbols[] {0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12,
+                                              0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+                                              0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08,
+                                              0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0,
+                                              0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16,
+                                              0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+                                              0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+                                              0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+                                              0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+                                              0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+                                              0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79,
+                                              0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+                                              0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98,
+                                              0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+                                              0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6,
+                                              0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5,
+                                              0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4,
+                                              0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+                                              0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA,
+                                              0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8,
+                                              0xF9, 0xFA};
+    static const HuffmanTable table = BuildHuffmanTable(bits, symbols);
+    return table;
+  }
+
+  static const CategoryTable &GetCategoryTable()
+  {
+    static const CategoryTable table = []()
+                                         {
+                                           CategoryTable categories;
+                                           unsigned char category = 0;
+                                           for (size_t magnitude = 0; magnitude < categories.size(); magnitude++)
+                                           {
+                                             if (magnitude >= (1U << category)) //Next power of two reached
+                                               category++;
+                                             categories[magnitude] = category;
+                                           }
+                                           return categories;
+                                         }();
+    return table;
+  }
+
+  static constexpr int max_dc_difference = 2047; //Largest DC difference in the DC table (category 11)
+  static constexpr int max_ac_value = 1023; //Largest AC magnitude in the AC table (category 10)
+  static constexpr unsigned int max_run = 15; //Longest run of zeros which can be coded with a single symbol
+  static constexpr unsigned char eob_symbol = 0x00; //End of block
+  static constexpr unsigned char zrl_symbol = 0xF0; //Run of 16 zeros
+
+  static void WriteSymbol(const HuffmanTable &table, const unsigned char symbol, comutils::BitWriter &writer)
+  {
+    assert(table.lengths[symbol] != 0);
+    writer.WriteBits(table.codes[symbol], table.lengths[symbol]);
+  }
+
+  static void WriteValue(const HuffmanTable &table, const unsigned int run, const int value, comutils::BitWriter &writer)
+  {
+    assert(run <= max_run);
+    const unsigned int magnitude = std::abs(value);
+    const unsigned int size = GetCategoryTable()[magnitude];
+    const unsigned char symbol = (run << 4) | size;
+    assert(table.lengths[symbol] != 0);
+    const uint32_t amplitude_bits = value >= 0 ? value : value + (1 << size) - 1; //Negative values are represented by the lowest bits of value - 1 (one's complement)
+    writer.WriteBits((static_cast<uint32_t>(table.codes[symbol]) << size) | amplitude_bits, table.lengths[symbol] + size); //Write code word and amplitude at once
+  }
+
+  BlockEntropyCoder::BlockEntropyCoder(const unsigned int block_size)
+   : block_size(block_size),
+     scan_indices(ZigZagScanIndices(block_size)),
+     previous_dc(0) { }
+
+  size_t BlockEntropyCoder::EncodeBlock(const cv::Mat &quantized_coefficients, comutils::BitWriter &writer)
+  {
+    assert(quantized_coefficients.type() == CV_16SC1);
+    assert(quantized_coefficients.rows == static_cast<int>(block_size) && quantized_coefficients.cols == static_cast<int>(block_size));
+    const auto &dc_table = GetDCTable();
+    const auto &ac_table = GetACTable();
+    const auto coefficient = [&quantized_coefficients](const CoefficientIndex &index)
+                               {
+                                 return static_cast<int>(quantized_coefficients.ptr<short>(index.second)[index.first]);
+                               };
+    const size_t previous_bit_count = writer.GetBitCount();
+    const int dc = coefficient(scan_indices.front());
+    WriteValue(dc_table, 0, std::clamp(dc - previous_dc, -max_dc_difference, max_dc_difference), writer);
+    previous_dc = dc;
+    unsigned int run = 0;
+    for (auto it = scan_indices.begin() + 1; it != scan_indices.end(); ++it) //Skip DC coefficient
+    {
+      const int value = coefficient(*it);
+      if (value == 0)
+        run++;
+      else
+      {
+        for (; run > max_run; run -= max_run + 1) //Split long runs into runs of 16 zeros
+          WriteSymbol(ac_table, zrl_symbol, writer);
+        WriteValue(ac_table, run, std::clamp(value, -max_ac_value, max_ac_value), writer); //Values outside of the range of the code table are saturated
+        run = 0;
+      }
+    }
+    if (run != 0) //Trailing zeros are signalled by an end-of-block symbol
+      WriteSymbol(ac_table, eob_symbol, writer);
+    return writer.GetBitCount() - previous_bit_count;
+  }
+
+  void BlockEntropyCoder::ResetDCPrediction()
+  {
+    previous_dc = 0;
+  }
+
+  unsigned int BlockEntropyCoder::GetBlockSize() const
+  {
+    return block_size;
+  }
+}
@@ -0,0 +1,43 @@
+//Entropy coding functions for transform coefficients (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "bitwriter.hpp"
+
+namespace imgutils
+{
+  //Position (X and Y index) of a coefficient within a block
+  using CoefficientIndex = std::pair<size_t, size_t>;
+
+  //Returns the positions of all coefficients of a square block with the specified size in zig-zag scan order
+  std::vector<CoefficientIndex> ZigZagScanIndices(const unsigned int block_size);
+
+  //Run-length and Huffman codes square blocks of quantized coefficients like baseline JPEG, i.e., with DC prediction and the standard luminance code tables
+  class BlockEntropyCoder
+  {
+    public:
+      //Creates a new entropy coder for blocks of the specified size
+      BlockEntropyCoder(const unsigned int block_size);
+
+      //Writes the coded representation of the specified block of quantized coefficients (signed 16-bit values) and returns the number of bits written. The DC coefficient is predicted from the previously coded block.
+      size_t EncodeBlock(const cv::Mat &quantized_coefficients, comutils::BitWriter &writer);
+      //Resets the DC prediction so that the next block is predicted from zero
+      void ResetDCPrediction();
+
+      //Returns the block size specified during construction
+      unsigned int GetBlockSize() const;
+
+    private:
+      const unsigned int block_size;
+      std::vector<CoefficientIndex> scan_indices;
+      int previous_dc;
+  };
+}
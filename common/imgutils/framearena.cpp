@@ -0,0 +1,245 @@
+//Per-frame arena for temporary matrices
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <new>
+
+#include <opencv2/core.hpp>
+
+#include "framearena.hpp"
+
+namespace imgutils
+{
+  static constexpr size_t alignment = 64; //Same as cv::fastMalloc
+  static constexpr size_t default_chunk_size = static_cast<size_t>(1) << 22; //4 MiB; larger matrices get a chunk of their own
+  static constexpr size_t header_size = (sizeof(cv::UMatData) + alignment - 1) / alignment * alignment; //Each allocation starts with its matrix data descriptor so that the heap is not used for it either
+
+  static size_t Align(const size_t size)
+  {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  struct Arena;
+
+  //Contiguous block of memory from which allocations are taken consecutively. It can only be reused once all allocations from it have been released.
+  struct Chunk
+  {
+    Arena * const arena;
+    unsigned char * const memory;
+    const size_t capacity;
+    size_t used;
+    size_t live_allocations;
+
+    Chunk(Arena * const arena, const size_t capacity)
+     : arena(arena), memory(static_cast<unsigned char*>(std::aligned_alloc(alignment, capacity))), capacity(capacity), used(0), live_allocations(0)
+    {
+      if (!memory)
+        throw std::bad_alloc();
+    }
+
+    ~Chunk()
+    {
+      std::free(memory);
+    }
+  };
+
+  struct Arena
+  {
+    std::mutex mutex; //Protects all members except depth since matrices can be released by any thread
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk*> free_chunks; //Chunks without live allocations
+    Chunk *current = nullptr; //Chunk which allocations are currently taken from
+    size_t live_allocations = 0;
+    bool orphaned = false; //The owning thread has ended, but there are still live allocations
+    unsigned int depth = 0; //Number of active scopes (only accessed by the owning thread)
+
+    //Returns a free chunk with at least the specified capacity, creating one if necessary (requires the mutex to be locked)
+    Chunk *AcquireChunk(const size_t size)
+    {
+      for (auto it = free_chunks.begin(); it != free_chunks.end(); ++it)
+      {
+        Chunk * const chunk = *it;
+        if (chunk->capacity >= size)
+        {
+          free_chunks.erase(it);
+          return chunk;
+        }
+      }
+      chunks.push_back(std::make_unique<Chunk>(this, std::max(default_chunk_size, Align(size))));
+      return chunks.back().get();
+    }
+
+    //Stops taking allocations from the current chunk. It is reused immediately if all of its allocations have been released already (requires the mutex to be locked).
+    void RetireCurrentChunk()
+    {
+      if (current && !current->live_allocations)
+      {
+        current->used = 0;
+        free_chunks.push_back(current);
+      }
+      current = nullptr;
+    }
+
+    unsigned char *Allocate(const size_t size, Chunk *&chunk)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (current && !current->live_allocations) //Rewind if everything taken from the current chunk has been released already
+        current->used = 0;
+      if (!current || current->used + size > current->capacity)
+      {
+        RetireCurrentChunk();
+        current = AcquireChunk(size);
+      }
+      chunk = current;
+      unsigned char * const memory = chunk->memory + chunk->used;
+      chunk->used += size;
+      chunk->live_allocations++;
+      live_allocations++;
+      return memory;
+    }
+
+    //Returns true if the arena has been orphaned and can be deleted now
+    bool Release(Chunk * const chunk)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      assert(chunk->live_allocations && live_allocations);
+      chunk->live_allocations--;
+      live_allocations--;
+      if (!chunk->live_allocations && chunk != current) //Retired chunks become reusable once their last allocation has been released
+      {
+        chunk->used = 0;
+        free_chunks.push_back(chunk);
+      }
+      return orphaned && !live_allocations;
+    }
+
+    void Reset()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      RetireCurrentChunk(); //If there are still live allocations, the next frame starts in another chunk
+    }
+
+    size_t GetReservedBytes()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t reserved_bytes = 0;
+      for (const auto &chunk : chunks)
+        reserved_bytes += chunk->capacity;
+      return reserved_bytes;
+    }
+  };
+
+  //Owns the arena of a thread. The arena outlives the thread if matrices allocated from it are still alive.
+  struct ArenaOwner
+  {
+    Arena * const arena = new Arena;
+
+    ~ArenaOwner()
+    {
+      bool unused;
+      {
+        std::lock_guard<std::mutex> lock(arena->mutex);
+        arena->orphaned = true;
+        unused = !arena->live_allocations;
+      }
+      if (unused)
+        delete arena;
+    }
+  };
+
+  static thread_local Arena *active_arena = nullptr; //Set while a scope is active
+
+  static Arena &GetThreadArena()
+  {
+    static thread_local ArenaOwner owner; //Only created once a thread uses a scope
+    return *owner.arena;
+  }
+
+  //Allocator which takes matrix data from the active arena of the calling thread, if any, and uses the previous default allocator otherwise. It installs itself as default allocator.
+  class FrameAllocator : public cv::MatAllocator
+  {
+    public:
+      FrameAllocator()
+       : fallback(cv::Mat::getDefaultAllocator())
+      {
+        cv::Mat::setDefaultAllocator(this);
+      }
+
+      cv::UMatData *allocate(int dims, const int *sizes, int type, void *data, size_t *step, cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override
+      {
+        Arena * const arena = active_arena;
+        if (!arena || data) //External data is not managed by any allocator
+          return fallback->allocate(dims, sizes, type, data, step, flags, usage_flags);
+        size_t total = CV_ELEM_SIZE(type);
+        for (int i = dims - 1; i >= 0; i--) //Continuous data (see cv::StdMatAllocator)
+        {
+          if (step)
+            step[i] = total;
+          total *= sizes[i];
+        }
+        Chunk *chunk;
+        unsigned char * const memory = arena->Allocate(header_size + Align(total), chunk);
+        cv::UMatData * const u = new (memory) cv::UMatData(this);
+        u->data = u->origdata = memory + header_size;
+        u->size = total;
+        u->userdata = chunk;
+        return u;
+      }
+
+      bool allocate(cv::UMatData *data, cv::AccessFlag, cv::UMatUsageFlags) const override
+      {
+        return data != nullptr; //Data is always in host memory (see cv::StdMatAllocator)
+      }
+
+      void deallocate(cv::UMatData *data) const override
+      {
+        if (!data)
+          return;
+        assert(data->currAllocator == this);
+        Chunk * const chunk = static_cast<Chunk*>(data->userdata);
+        data->~UMatData();
+        Arena * const arena = chunk->arena;
+        if (arena->Release(chunk)) //The last allocation of an ended thread's arena has been released
+          delete arena;
+      }
+
+    private:
+      const cv::MatAllocator * const fallback;
+  };
+
+  static void InstallFrameAllocator()
+  {
+    static const FrameAllocator * const allocator = new FrameAllocator(); //Never destroyed since matrices may still be released during static destruction
+    (void)allocator;
+  }
+
+  FrameArenaScope::FrameArenaScope()
+  {
+    InstallFrameAllocator();
+    Arena &arena = GetThreadArena();
+    arena.depth++;
+    active_arena = &arena;
+  }
+
+  FrameArenaScope::~FrameArenaScope()
+  {
+    Arena &arena = GetThreadArena();
+    assert(arena.depth);
+    if (!--arena.depth)
+    {
+      active_arena = nullptr;
+      arena.Reset();
+    }
+  }
+
+  size_t FrameArenaScope::GetReservedBytes()
+  {
+    return GetThreadArena().GetReservedBytes();
+  }
+}
@@ -0,0 +1,25 @@
+//Per-frame arena for temporary matrices (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+
+namespace imgutils
+{
+  //Scope in which the data of all matrices allocated by the calling thread is taken from a per-thread arena instead of the heap. Scopes can be nested. When the outermost scope ends, the arena is reset so that the next frame reuses its memory.
+  //Matrices which outlive the scope, e.g., window contents, remain valid. The memory they occupy is only reused once they have been released, so that steady-state animations do not allocate memory after the first few frames.
+  class FrameArenaScope
+  {
+    public:
+      //Activates the arena of the calling thread
+      FrameArenaScope();
+      FrameArenaScope(const FrameArenaScope &original) = delete; //Explicitly delete the copy constructor since the scope belongs to one thread
+      //Deactivates the arena of the calling thread and resets it if this is the outermost scope
+      ~FrameArenaScope();
+
+      //Returns the total size in bytes of all memory reserved by the arena of the calling thread
+      static size_t GetReservedBytes();
+  };
+}
@@ -1,10 +1,24 @@
 //Helper functions for calculations on images
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+#include "common.hpp"
 #include "math.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
 
 #include "imgmath.hpp"
+#include "imgmath.kernels.hpp"
 
 namespace imgutils
 {
@@ -32,23 +46,246 @@ namespace imgutils
     return comutils::GetLevelFromValue(max_error, sqrt(MSE));
   }
 
+  static const ImageMetricKernels &GetKernels()
+  {
+    static const ImageMetricKernels &kernels = CPU_DISPATCH_SELECT(image_metric_kernels);
+    return kernels;
+  }
+
+  //Calculates the sums of absolute and squared differences per channel of two images in a single pass
+  static DifferenceSums CalculateDifferenceSums(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    assert(image1.depth() == CV_8U && image1.type() == image2.type());
+    assert(image1.size() == image2.size());
+    assert(image1.channels() <= 4);
+    constexpr int pixels_per_task = 1 << 16; //Minimum number of pixels processed by one task so that small images, e.g., blocks, are not split
+    const size_t rows_per_task = std::max(1, pixels_per_task / std::max(1, image1.cols));
+    const auto add_row_sums = GetKernels().AddDifferenceSums[image1.channels() - 1];
+    if (static_cast<size_t>(image1.rows) <= rows_per_task) //Sum small images, e.g., blocks during motion estimation, directly so that no memory is allocated per call
+    {
+      DifferenceSums sums {};
+      for (int y = 0; y < image1.rows; y++)
+        add_row_sums(image1.ptr<unsigned char>(y), image2.ptr<unsigned char>(y), image1.cols, sums);
+      return sums;
+    }
+    std::vector<DifferenceSums> task_sums((image1.rows + rows_per_task - 1) / rows_per_task, DifferenceSums {});
+    comutils::ParallelFor(image1.rows, rows_per_task, [&](const size_t first_row, const size_t last_row)
+                                                         {
+                                                           auto &sums = task_sums[first_row / rows_per_task];
+                                                           for (size_t y = first_row; y < last_row; y++)
+                                                             add_row_sums(image1.ptr<unsigned char>(y), image2.ptr<unsigned char>(y), image1.cols, sums);
+                                                         });
+    DifferenceSums sums {};
+    for (const auto &partial_sums : task_sums) //Integer sums do not depend on the order
+    {
+      for (size_t channel = 0; channel < comutils::arraysize(sums.absolute); channel++)
+      {
+        sums.absolute[channel] += partial_sums.absolute[channel];
+        sums.squared[channel] += partial_sums.squared[channel];
+      }
+    }
+    return sums;
+  }
+
+  double SAD(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const auto SADs = SADPerChannel(image1, image2);
+    return SADs[0] + SADs[1] + SADs[2] + SADs[3];
+  }
+
+  double SSD(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const auto SSDs = SSDPerChannel(image1, image2);
+    return SSDs[0] + SSDs[1] + SSDs[2] + SSDs[3];
+  }
+
+  double MSE(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    assert(image1.total() != 0);
+    return SSD(image1, image2) / (image1.total() * image1.channels());
+  }
+
+  double PSNR(const cv::Mat &image1, const cv::Mat &image2, const double max_error)
+  {
+    return PSNR(MSE(image1, image2), max_error);
+  }
+
+  cv::Scalar SADPerChannel(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const auto sums = CalculateDifferenceSums(image1, image2);
+    return cv::Scalar(sums.absolute[0], sums.absolute[1], sums.absolute[2], sums.absolute[3]);
+  }
+
+  cv::Scalar SSDPerChannel(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const auto sums = CalculateDifferenceSums(image1, image2);
+    return cv::Scalar(sums.squared[0], sums.squared[1], sums.squared[2], sums.squared[3]);
+  }
+
+  cv::Scalar MSEPerChannel(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    assert(image1.total() != 0);
+    return SSDPerChannel(image1, image2) / static_cast<double>(image1.total());
+  }
+
+  cv::Scalar PSNRPerChannel(const cv::Mat &image1, const cv::Mat &image2, const double max_error)
+  {
+    const auto MSEs = MSEPerChannel(image1, image2);
+    cv::Scalar PSNRs;
+    for (int channel = 0; channel < image1.channels(); channel++)
+      PSNRs[channel] = PSNR(MSEs[channel], max_error);
+    return PSNRs;
+  }
+
+  //Calculates the mean SSIM and the mean contrast-structure term of two single-channel images over all windows. The window sums are updated incrementally from row to row so that each pixel is only read twice.
+  static void CalculateSSIMComponents(const cv::Mat &image1, const cv::Mat &image2, double &ssim, double &contrast_structure)
+  {
+    assert(image1.type() == CV_8UC1 && image2.type() == CV_8UC1);
+    assert(image1.size() == image2.size());
+    assert(image1.cols >= ssim_window_size && image1.rows >= ssim_window_size);
+    const int width = image1.cols;
+    const int window_count = width - ssim_window_size + 1;
+    std::vector<int> column_sums(ssim_statistics_count * width, 0); //Sums of the pixel values, squared pixel values and products of pixel values of two images per column over a window of rows (see ImageMetricKernels for the order)
+    int * const sums[] {&column_sums[0], &column_sums[width], &column_sums[2 * width], &column_sums[3 * width], &column_sums[4 * width]};
+    const int * const window_sums[] {sums[0], sums[1], sums[2], sums[3], sums[4]};
+    static_assert(comutils::arraysize(sums) == ssim_statistics_count && comutils::arraysize(window_sums) == ssim_statistics_count, "All statistics need to be updated and evaluated");
+    const auto &kernels = GetKernels();
+    double ssim_sum = 0;
+    double contrast_structure_sum = 0;
+    for (int y = 0; y < image1.rows; y++)
+    {
+      kernels.AddSSIMColumnSums(image1.ptr<unsigned char>(y), image2.ptr<unsigned char>(y), width, sums);
+      if (y >= ssim_window_size) //Remove the row which has left the window
+        kernels.SubtractSSIMColumnSums(image1.ptr<unsigned char>(y - ssim_window_size), image2.ptr<unsigned char>(y - ssim_window_size), width, sums);
+      if (y >= ssim_window_size - 1) //Window is complete
+        kernels.AddWindowSSIMs(window_sums, window_count, ssim_sum, contrast_structure_sum);
+    }
+    const double total_window_count = static_cast<double>(window_count) * (image1.rows - ssim_window_size + 1);
+    ssim = ssim_sum / total_window_count;
+    contrast_structure = contrast_structure_sum / total_window_count;
+  }
+
+  static double CalculateSingleChannelSSIM(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    double ssim, contrast_structure;
+    CalculateSSIMComponents(image1, image2, ssim, contrast_structure);
+    return ssim;
+  }
+
+  static double CalculateSingleChannelMSSSIM(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    constexpr double weights[] {0.0448, 0.2856, 0.3001, 0.2363, 0.1333}; //Weights per scale (see Wang et al.)
+    const int min_size = std::min(image1.cols, image1.rows);
+    size_t scale_count = 1;
+    while (scale_count < comutils::arraysize(weights) && (min_size >> scale_count) >= ssim_window_size) //Each scale halves the size
+      scale_count++;
+    const double weight_sum = std::accumulate(std::begin(weights), std::begin(weights) + scale_count, 0.0);
+    cv::Mat scaled_image1 = image1;
+    cv::Mat scaled_image2 = image2;
+    double ms_ssim = 1;
+    for (size_t scale = 0; scale < scale_count; scale++)
+    {
+      double ssim, contrast_structure;
+      CalculateSSIMComponents(scaled_image1, scaled_image2, ssim, contrast_structure);
+      const double weight = weights[scale] / weight_sum;
+      if (scale == scale_count - 1) //Luminance is only considered at the coarsest scale
+        ms_ssim *= pow(std::max(ssim, 0.0), weight); //Negative values (anti-correlation) are clipped
+      else
+      {
+        ms_ssim *= pow(std::max(contrast_structure, 0.0), weight);
+        const cv::Size downscaled_size(scaled_image1.cols / 2, scaled_image1.rows / 2);
+        const cv::Rect even_area(cv::Point(), downscaled_size * 2); //Skip the last row and column of odd-sized images so that 2x2 blocks can be averaged
+        cv::Mat downscaled_image1, downscaled_image2;
+        cv::resize(scaled_image1(even_area), downscaled_image1, downscaled_size, 0, 0, cv::INTER_AREA);
+        cv::resize(scaled_image2(even_area), downscaled_image2, downscaled_size, 0, 0, cv::INTER_AREA);
+        scaled_image1 = downscaled_image1;
+        scaled_image2 = downscaled_image2;
+      }
+    }
+    return ms_ssim;
+  }
+
+  //Calculates a metric for single-channel images for each channel (in parallel) and returns the mean
+  static double CalculateChannelMean(const cv::Mat &image1, const cv::Mat &image2, double (* const metric)(const cv::Mat&, const cv::Mat&))
+  {
+    assert(image1.depth() == CV_8U && image1.type() == image2.type());
+    assert(image1.size() == image2.size());
+    const int channels = image1.channels();
+    if (channels == 1)
+      return metric(image1, image2);
+    double values[CV_CN_MAX];
+    comutils::ParallelFor(channels, 1, [&](const size_t first_channel, const size_t last_channel)
+                                          {
+                                            cv::Mat channel1, channel2;
+                                            for (size_t channel = first_channel; channel < last_channel; channel++)
+                                            {
+                                              cv::extractChannel(image1, channel1, channel);
+                                              cv::extractChannel(image2, channel2, channel);
+                                              values[channel] = metric(channel1, channel2);
+                                            }
+                                          });
+    return std::accumulate(values, values + channels, 0.0) / channels; //Sum in channel order so that the result does not depend on the order of execution
+  }
+
+  bool IsSSIMSupported(const cv::Size &size)
+  {
+    return size.width >= ssim_window_size && size.height >= ssim_window_size;
+  }
+
+  //Throws an exception if the images are too small for a single SSIM window so that no division by zero occurs, even when assertions are disabled
+  static void CheckSSIMImageSize(const cv::Mat &image)
+  {
+    if (!IsSSIMSupported(image.size()))
+      throw std::invalid_argument("SSIM requires images of at least " + std::to_string(ssim_window_size) + "x" + std::to_string(ssim_window_size) + " pixels");
+  }
+
+  double SSIM(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const comutils::TraceScope trace_scope("SSIM");
+    CheckSSIMImageSize(image1);
+    return CalculateChannelMean(image1, image2, CalculateSingleChannelSSIM);
+  }
+
+  double MSSSIM(const cv::Mat &image1, const cv::Mat &image2)
+  {
+    const comutils::TraceScope trace_scope("MSSSIM");
+    CheckSSIMImageSize(image1);
+    return CalculateChannelMean(image1, image2, CalculateSingleChannelMSSSIM);
+  }
+
   cv::Mat ImageLevelShift(const cv::Mat &image)
   {
-    assert(image.type() == CV_8UC1);
-    auto &original_image = static_cast<const cv::Mat_<unsigned char>>(image);
-    cv::Mat_<double> shifted_image(image.rows, image.cols);
-    std::transform(original_image.begin(), original_image.end(), shifted_image.begin(), LevelShift);
+    cv::Mat shifted_image;
+    ImageLevelShift(image, shifted_image);
     return shifted_image;
   }
 
+  void ImageLevelShift(const cv::Mat &image, cv::Mat &shifted_image, const int depth)
+  {
+    assert(image.type() == CV_8UC1);
+    assert(depth == CV_32F || depth == CV_64F);
+    image.convertTo(shifted_image, depth, 1, LevelShift(0)); //Conversion, scaling and shifting are performed in a single (vectorized) pass
+  }
+
+  void LevelShiftedDCT(const cv::Mat &image, cv::Mat &coefficients, const int depth)
+  {
+    const comutils::TraceScope trace_scope("LevelShiftedDCT");
+    ImageLevelShift(image, coefficients, depth);
+    cv::dct(coefficients, coefficients); //Transform in place to avoid an intermediate level-shifted image
+  }
+
   cv::Mat ReverseImageLevelShift(const cv::Mat &image)
   {
-    assert(image.type() == CV_64FC1);
-    auto &original_image = static_cast<const cv::Mat_<double>>(image);
-    cv::Mat_<unsigned char> shifted_image(image.rows, image.cols);
-    std::transform(original_image.begin(), original_image.end(), shifted_image.begin(), ReverseLevelShift);
+    cv::Mat shifted_image;
+    ReverseImageLevelShift(image, shifted_image);
     return shifted_image;
   }
+
+  void ReverseImageLevelShift(const cv::Mat &image, cv::Mat &shifted_image)
+  {
+    assert(image.type() == CV_32FC1 || image.type() == CV_64FC1);
+    image.convertTo(shifted_image, CV_8U, 1, ReverseLevelShift(0)); //Rounds and saturates to [0;255]
+  }
   
   cv::Mat GetRaw2DDCTBasisFunctionImage(const unsigned int block_size, const unsigned int i, const unsigned int j, const double amplitude)
   {
@@ -1,5 +1,5 @@
 //Helper functions for calculations on images (header)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
@@ -19,9 +19,38 @@ namespace imgutils
 
   //Calculates the peak signal (maximum error) to noise ratio from the mean squared error
   double PSNR(const double MSE, const double max_error = 255);
+
+  //Calculates the sum of absolute differences between two unsigned 8-bit images (or regions of interest) of the same size and type without an intermediate difference image. For images with multiple channels, the sums of all channels are added.
+  double SAD(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the sum of squared differences between two unsigned 8-bit images (or regions of interest) of the same size and type without an intermediate difference image. For images with multiple channels, the sums of all channels are added.
+  double SSD(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the mean squared error between two unsigned 8-bit images (or regions of interest) of the same size and type over all samples of all channels without an intermediate difference image
+  double MSE(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the peak signal (maximum error) to noise ratio between two unsigned 8-bit images (or regions of interest) of the same size and type over all samples of all channels
+  double PSNR(const cv::Mat &image1, const cv::Mat &image2, const double max_error = 255);
+
+  //Calculates the sum of absolute differences between two unsigned 8-bit images (or regions of interest) with up to four channels for each channel separately
+  cv::Scalar SADPerChannel(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the sum of squared differences between two unsigned 8-bit images (or regions of interest) with up to four channels for each channel separately
+  cv::Scalar SSDPerChannel(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the mean squared error between two unsigned 8-bit images (or regions of interest) with up to four channels for each channel separately
+  cv::Scalar MSEPerChannel(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the peak signal (maximum error) to noise ratio between two unsigned 8-bit images (or regions of interest) with up to four channels for each channel separately
+  cv::Scalar PSNRPerChannel(const cv::Mat &image1, const cv::Mat &image2, const double max_error = 255);
+
+  //Returns true if images of the specified size are large enough for SSIM and MS-SSIM, i.e., at least as large as one 8x8 window
+  bool IsSSIMSupported(const cv::Size &size);
+  //Calculates the mean structural similarity (SSIM) index of two unsigned 8-bit images of the same size with sliding 8x8 windows. For images with multiple channels, the mean across all channels is returned. Throws std::invalid_argument if the images are smaller than one window (see IsSSIMSupported).
+  double SSIM(const cv::Mat &image1, const cv::Mat &image2);
+  //Calculates the multi-scale structural similarity (MS-SSIM) index of two unsigned 8-bit images of the same size over up to five dyadic scales with the weights proposed by Wang et al. Images which are too small for five scales are evaluated with fewer scales and renormalized weights. For images with multiple channels, the mean across all channels is returned. Throws std::invalid_argument if the images are smaller than one window (see IsSSIMSupported).
+  double MSSSIM(const cv::Mat &image1, const cv::Mat &image2);
   
   //Shifts all pixels of an unsigned 8-bit input image by half the range (128) and returns a 64-bit (double) output image
   cv::Mat ImageLevelShift(const cv::Mat &image);
+  //Shifts all pixels of an unsigned 8-bit input image (or region of interest) by half the range (128) and writes them into a 32-bit (float) or 64-bit (double) output image with the specified depth. The output image is (re)allocated only if its size or type does not match.
+  void ImageLevelShift(const cv::Mat &image, cv::Mat &shifted_image, const int depth = CV_64F);
+  //Level-shifts an unsigned 8-bit input image (or region of interest) and calculates its 2-D-DCT coefficients with the specified floating-point depth. The level-shifted values are written directly into the coefficient matrix, which is then transformed in place.
+  void LevelShiftedDCT(const cv::Mat &image, cv::Mat &coefficients, const int depth = CV_64F);
   
   //Shifts a value by half of the 8-bit range (128)
   constexpr double LevelShift(const double value);
@@ -30,6 +59,8 @@ namespace imgutils
   
   //Shifts all pixels of a 64-bit (double) input image back by half the range (128) and returns an unsigned 8-bit output image
   cv::Mat ReverseImageLevelShift(const cv::Mat &image);
+  //Shifts all pixels of a 32-bit (float) or 64-bit (double) input image back by half the range (128) and writes them into an unsigned 8-bit output image, rounding and saturating values outside of the 8-bit range. The output image is (re)allocated only if its size or type does not match.
+  void ReverseImageLevelShift(const cv::Mat &image, cv::Mat &shifted_image);
   
   //Generates a 64-bit (dobule) image of the 2-D-DCT basis function with indices (i, j) and the specified amplitude. The default amplitude is the maximum 8-bit amplitude of 255 from the range [0;255]
   cv::Mat GetRaw2DDCTBasisFunctionImage(const unsigned int block_size, const unsigned int i, const unsigned int j, const double amplitude);
@@ -0,0 +1,177 @@
+//Helper functions for calculations on images (kernels, compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <cstdint>
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "imgmath.kernels.hpp"
+
+namespace imgutils
+{
+#if CV_SIMD
+  //Loads the next vector of samples of each channel from interleaved pixels
+  template<int channels>
+  static inline void LoadChannels(const unsigned char * const pixels, cv::v_uint8 (&values)[channels])
+  {
+    if constexpr (channels == 1)
+      values[0] = cv::vx_load(pixels);
+    else if constexpr (channels == 2)
+      cv::v_load_deinterleave(pixels, values[0], values[1]);
+    else if constexpr (channels == 3)
+      cv::v_load_deinterleave(pixels, values[0], values[1], values[2]);
+    else
+      cv::v_load_deinterleave(pixels, values[0], values[1], values[2], values[3]);
+  }
+#endif
+
+  template<int channels>
+  static void AddDifferenceSums(const unsigned char * const row1, const unsigned char * const row2, const int width, DifferenceSums &sums)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int max_block_iterations = UINT32_MAX / (lanes * 255 * 255); //The sum of all 32-bit lanes grows by at most lanes * 255^2 per iteration, so the sums need to be flushed before their reduction overflows
+    const cv::v_uint8 ones = cv::vx_setall_u8(1);
+    while (x <= width - lanes)
+    {
+      cv::v_uint32 absolute_sums[channels], squared_sums[channels];
+      for (int channel = 0; channel < channels; channel++)
+      {
+        absolute_sums[channel] = cv::vx_setzero_u32();
+        squared_sums[channel] = cv::vx_setzero_u32();
+      }
+      for (int iteration = 0; iteration < max_block_iterations && x <= width - lanes; iteration++, x += lanes)
+      {
+        cv::v_uint8 values1[channels], values2[channels];
+        LoadChannels<channels>(row1 + channels * x, values1);
+        LoadChannels<channels>(row2 + channels * x, values2);
+        for (int channel = 0; channel < channels; channel++)
+        {
+          const cv::v_uint8 difference = cv::v_absdiff(values1[channel], values2[channel]);
+          absolute_sums[channel] = cv::v_add(absolute_sums[channel], cv::v_dotprod_expand(difference, ones)); //Sums of four neighboring absolute differences each
+          squared_sums[channel] = cv::v_add(squared_sums[channel], cv::v_dotprod_expand(difference, difference)); //Sums of four neighboring squared differences each
+        }
+      }
+      for (int channel = 0; channel < channels; channel++) //Flush 32-bit lanes into the 64-bit sums
+      {
+        sums.absolute[channel] += cv::v_reduce_sum(absolute_sums[channel]);
+        sums.squared[channel] += cv::v_reduce_sum(squared_sums[channel]);
+      }
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+    {
+      for (int channel = 0; channel < channels; channel++)
+      {
+        const int difference = static_cast<int>(row1[channels * x + channel]) - row2[channels * x + channel];
+        sums.absolute[channel] += difference < 0 ? -difference : difference;
+        sums.squared[channel] += difference * difference;
+      }
+    }
+  }
+
+  //Adds (positive sign) or subtracts (negative sign) one row of pixel values of both images to or from the column sums
+  template<int sign>
+  static void UpdateSSIMColumnSums(const unsigned char * const row1, const unsigned char * const row2, const int width, int * const (&sums)[ssim_statistics_count])
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const int lanes_32 = cv::VTraits<cv::v_int32>::vlanes();
+    for (; x <= width - lanes; x += lanes)
+    {
+      cv::v_uint16 values1[2], values2[2];
+      cv::v_expand(cv::vx_load(row1 + x), values1[0], values1[1]);
+      cv::v_expand(cv::vx_load(row2 + x), values2[0], values2[1]);
+      for (int half = 0; half < 2; half++)
+      {
+        const cv::v_uint16 statistics[] {values1[half], values2[half], cv::v_mul(values1[half], values1[half]), cv::v_mul(values2[half], values2[half]), cv::v_mul(values1[half], values2[half])}; //Products of 8-bit values fit into 16 bits
+        for (size_t i = 0; i < ssim_statistics_count; i++)
+        {
+          cv::v_uint32 parts[2];
+          cv::v_expand(statistics[i], parts[0], parts[1]);
+          for (int part = 0; part < 2; part++)
+          {
+            int * const sum = sums[i] + x + (2 * half + part) * lanes_32;
+            const cv::v_int32 value = cv::v_reinterpret_as_s32(parts[part]);
+            cv::v_store(sum, sign > 0 ? cv::v_add(cv::vx_load(sum), value) : cv::v_sub(cv::vx_load(sum), value));
+          }
+        }
+      }
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+    {
+      const int value1 = row1[x];
+      const int value2 = row2[x];
+      const int statistics[] {value1, value2, value1 * value1, value2 * value2, value1 * value2};
+      for (size_t i = 0; i < ssim_statistics_count; i++)
+        sums[i][x] += sign * statistics[i];
+    }
+  }
+
+  //Calculates the SSIM and the contrast-structure term of a window from its sums (see SSIMColumnSums for the order)
+  static inline void CalculateWindowSSIM(const double (&sums)[ssim_statistics_count], double &ssim, double &contrast_structure)
+  {
+    const double product_of_sums = sums[0] * sums[1];
+    const double sum_of_squares = sums[0] * sums[0] + sums[1] * sums[1];
+    const double luminance = (2 * product_of_sums + ssim_c1) / (sum_of_squares + ssim_c1);
+    contrast_structure = (2 * (ssim_window_area * sums[4] - product_of_sums) + ssim_c2) / (ssim_window_area * (sums[2] + sums[3]) - sum_of_squares + ssim_c2);
+    ssim = luminance * contrast_structure;
+  }
+
+  static void AddWindowSSIMs(const int * const (&sums)[ssim_statistics_count], const int window_count, double &ssim_sum, double &contrast_structure_sum)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 c1 = cv::vx_setall_f32(ssim_c1), c2 = cv::vx_setall_f32(ssim_c2);
+    const cv::v_int32 area = cv::vx_setall_s32(ssim_window_area);
+    cv::v_float32 ssim_sums = cv::vx_setzero_f32(), contrast_structure_sums = cv::vx_setzero_f32(); //Sums per row only so that the single-precision rounding errors do not accumulate
+    for (; x <= window_count - lanes; x += lanes)
+    {
+      cv::v_int32 window_sums[ssim_statistics_count];
+      for (size_t i = 0; i < ssim_statistics_count; i++)
+      {
+        window_sums[i] = cv::vx_load(sums[i] + x);
+        for (int offset = 1; offset < ssim_window_size; offset++) //Add the column sums of all columns of the window
+          window_sums[i] = cv::v_add(window_sums[i], cv::vx_load(sums[i] + x + offset));
+      }
+      //All terms are calculated exactly in 32 bits (at most 2 * 64 * 64 * 255 * 255 < 2^31) so that the differences do not suffer from cancellation. Only the quotients are calculated in single precision.
+      const cv::v_int32 product_of_sums = cv::v_mul(window_sums[0], window_sums[1]);
+      const cv::v_int32 sum_of_squares = cv::v_add(cv::v_mul(window_sums[0], window_sums[0]), cv::v_mul(window_sums[1], window_sums[1]));
+      const cv::v_int32 covariance_term = cv::v_sub(cv::v_mul(area, window_sums[4]), product_of_sums);
+      const cv::v_int32 variance_term = cv::v_sub(cv::v_mul(area, cv::v_add(window_sums[2], window_sums[3])), sum_of_squares);
+      const cv::v_float32 luminance = cv::v_div(cv::v_add(cv::v_cvt_f32(cv::v_add(product_of_sums, product_of_sums)), c1), cv::v_add(cv::v_cvt_f32(sum_of_squares), c1));
+      const cv::v_float32 contrast_structure = cv::v_div(cv::v_add(cv::v_cvt_f32(cv::v_add(covariance_term, covariance_term)), c2), cv::v_add(cv::v_cvt_f32(variance_term), c2));
+      ssim_sums = cv::v_add(ssim_sums, cv::v_mul(luminance, contrast_structure));
+      contrast_structure_sums = cv::v_add(contrast_structure_sums, contrast_structure);
+    }
+    ssim_sum += cv::v_reduce_sum(ssim_sums);
+    contrast_structure_sum += cv::v_reduce_sum(contrast_structure_sums);
+    cv::vx_cleanup();
+#endif
+    for (; x < window_count; x++)
+    {
+      double window_sums[ssim_statistics_count] {};
+      for (size_t i = 0; i < ssim_statistics_count; i++)
+      {
+        for (int offset = 0; offset < ssim_window_size; offset++)
+          window_sums[i] += sums[i][x + offset];
+      }
+      double ssim, contrast_structure;
+      CalculateWindowSSIM(window_sums, ssim, contrast_structure);
+      ssim_sum += ssim;
+      contrast_structure_sum += contrast_structure;
+    }
+  }
+
+  const ImageMetricKernels CPU_DISPATCH_NAME(image_metric_kernels) {{AddDifferenceSums<1>, AddDifferenceSums<2>, AddDifferenceSums<3>, AddDifferenceSums<4>},
+                                                                    UpdateSSIMColumnSums<1>, UpdateSSIMColumnSums<-1>, AddWindowSSIMs};
+}
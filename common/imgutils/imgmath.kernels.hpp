@@ -0,0 +1,41 @@
+//Helper functions for calculations on images (kernels, header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpudispatch.hpp"
+
+namespace imgutils
+{
+  //Sums of absolute and squared differences per channel
+  struct DifferenceSums
+  {
+    uint64_t absolute[4];
+    uint64_t squared[4];
+  };
+
+  constexpr int ssim_window_size = 8; //Width and height of the sliding SSIM window
+  constexpr int ssim_window_area = ssim_window_size * ssim_window_size;
+  constexpr double ssim_c1 = (0.01 * 255) * (0.01 * 255) * ssim_window_area * ssim_window_area; //Stabilization constants by Wang et al., scaled so that they can be applied to window sums instead of means
+  constexpr double ssim_c2 = (0.03 * 255) * (0.03 * 255) * ssim_window_area * ssim_window_area;
+  constexpr size_t ssim_statistics_count = 5; //Sums of pixel values of both images, their squares and their products
+
+  //Row kernels for image metrics, compiled once per dispatch target (see cpudispatch.hpp). Kernels do not use OpenCV types so that only the intrinsics are compiled with the instruction sets of the target.
+  struct ImageMetricKernels
+  {
+    //Adds the absolute and squared differences of all pixels of two rows with one to four interleaved channels (index: number of channels minus one)
+    void (*AddDifferenceSums[4])(const unsigned char * const row1, const unsigned char * const row2, const int width, DifferenceSums &sums);
+    //Adds one row of pixel values of both images to the SSIM column sums (order: first image, second image, first image squared, second image squared, product)
+    void (*AddSSIMColumnSums)(const unsigned char * const row1, const unsigned char * const row2, const int width, int * const (&sums)[ssim_statistics_count]);
+    //Subtracts one row of pixel values of both images from the SSIM column sums (see AddSSIMColumnSums)
+    void (*SubtractSSIMColumnSums)(const unsigned char * const row1, const unsigned char * const row2, const int width, int * const (&sums)[ssim_statistics_count]);
+    //Adds the SSIM values and contrast-structure terms of one row of windows, given the column sums of the rows they cover
+    void (*AddWindowSSIMs)(const int * const (&sums)[ssim_statistics_count], const int window_count, double &ssim_sum, double &contrast_structure_sum);
+  };
+
+  CPU_DISPATCH_DECLARE(ImageMetricKernels, image_metric_kernels);
+}
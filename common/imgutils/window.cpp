@@ -1,5 +1,5 @@
 //Window abstraction
-// Andreas Unterweger, 2022
+// Andreas Unterweger, 2022-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <stdexcept>
@@ -7,6 +7,8 @@
 
 #include <opencv2/highgui.hpp>
 
+#include "trace.hpp"
+
 #include "window.hpp"
 
 namespace imgutils
@@ -233,6 +235,7 @@ namespace imgutils
   
   void Window::Update(const bool first_update)
   {
+    const comutils::TraceScope trace_scope("Window::Update");
     if (shown)
     {
       cv::imshow(title, content);
@@ -0,0 +1,231 @@
+//YCbCr conversion and chrominance subsampling functions
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+
+#include "common.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
+
+#include "ycbcr.hpp"
+#include "ycbcr.kernels.hpp"
+
+namespace imgutils
+{
+  static_assert(ycbcr_kernel_component_count == decomposition_component_count, "All components need to be written by the kernels");
+
+  static constexpr int pixels_per_task = 1 << 16; //Minimum number of pixels processed by one task so that small images are not split
+
+  //Returns the number of groups of rows (of the specified width) to be processed by one task
+  static size_t GetRowGroupsPerTask(const int width, const int rows_per_group)
+  {
+    return std::max(1, pixels_per_task / std::max(1, width * rows_per_group));
+  }
+
+  static const YCbCrKernels &GetKernels()
+  {
+    static const YCbCrKernels &kernels = CPU_DISPATCH_SELECT(ycbcr_kernels);
+    return kernels;
+  }
+
+  cv::Size GetChromaSubsamplingFactors(const ChromaFormat format)
+  {
+    switch (format)
+    {
+      case ChromaFormat::Format422:
+        return cv::Size(2, 1);
+      case ChromaFormat::Format411:
+        return cv::Size(4, 1);
+      case ChromaFormat::Format420:
+        return cv::Size(2, 2);
+      case ChromaFormat::Format444:
+      case ChromaFormat::Format400:
+      default:
+        return cv::Size(1, 1);
+    }
+  }
+
+  cv::Size GetChromaPlaneSize(const cv::Size &size, const ChromaFormat format)
+  {
+    if (format == ChromaFormat::Format400)
+      return cv::Size();
+    const auto factors = GetChromaSubsamplingFactors(format);
+    return cv::Size((size.width + factors.width - 1) / factors.width, (size.height + factors.height - 1) / factors.height); //Incomplete blocks of samples at the right and bottom borders yield one additional chrominance sample each
+  }
+
+  size_t GetPlanarImageSize(const cv::Size &size, const ChromaFormat format)
+  {
+    return size.area() + 2 * GetChromaPlaneSize(size, format).area();
+  }
+
+  //Repeats each sample of a row factor times
+  static void UpsampleRow(const unsigned char * const row, const int factor, const int width, unsigned char * const output)
+  {
+    for (int x = 0; x < width; x++)
+      output[x] = row[x / factor];
+  }
+
+  void ConvertBGRToPlanarYCbCr(const cv::Mat &image, cv::Mat &y_plane, cv::Mat &cb_plane, cv::Mat &cr_plane, const ChromaFormat format)
+  {
+    const comutils::TraceScope trace_scope("ConvertBGRToPlanarYCbCr");
+    assert(image.type() == CV_8UC3);
+    const int width = image.cols;
+    const int height = image.rows;
+    y_plane.create(image.size(), CV_8UC1);
+    const bool has_chroma = format != ChromaFormat::Format400;
+    if (has_chroma)
+    {
+      const auto chroma_size = GetChromaPlaneSize(image.size(), format);
+      cb_plane.create(chroma_size, CV_8UC1);
+      cr_plane.create(chroma_size, CV_8UC1);
+    }
+    else
+    {
+      cb_plane.release();
+      cr_plane.release();
+    }
+    const auto factors = GetChromaSubsamplingFactors(format);
+    const bool subsampled = has_chroma && format != ChromaFormat::Format444;
+    const auto &kernels = GetKernels();
+    const size_t group_count = (height + factors.height - 1) / factors.height; //Groups of all rows which contribute to one row of chrominance samples
+    comutils::ParallelFor(group_count, GetRowGroupsPerTask(width, factors.height), [&](const size_t first_group, const size_t last_group)
+                                                                                      {
+                                                                                        std::vector<unsigned char> chroma_rows(subsampled || !has_chroma ? 2 * factors.height * width : 0); //Full-resolution chrominance rows before subsampling (or to be discarded)
+                                                                                        unsigned char * const cb_rows = chroma_rows.data();
+                                                                                        unsigned char * const cr_rows = cb_rows + factors.height * width;
+                                                                                        for (size_t group = first_group; group < last_group; group++) //Process all rows of a group at once so that each pixel is only read once
+                                                                                        {
+                                                                                          const int first_row = group * factors.height;
+                                                                                          const int row_count = std::min(factors.height, height - first_row);
+                                                                                          for (int row = 0; row < row_count; row++)
+                                                                                          {
+                                                                                            const int y = first_row + row;
+                                                                                            if (has_chroma && !subsampled) //Write directly into the chrominance planes
+                                                                                              kernels.ConvertRowToYCbCr(image.ptr<unsigned char>(y), y_plane.ptr<unsigned char>(y), cb_plane.ptr<unsigned char>(y), cr_plane.ptr<unsigned char>(y), width);
+                                                                                            else
+                                                                                              kernels.ConvertRowToYCbCr(image.ptr<unsigned char>(y), y_plane.ptr<unsigned char>(y), cb_rows + row * width, cr_rows + row * width, width);
+                                                                                          }
+                                                                                          if (subsampled)
+                                                                                          {
+                                                                                            kernels.DownsampleRows(cb_rows, row_count, width, factors.width, factors.height, cb_plane.ptr<unsigned char>(group));
+                                                                                            kernels.DownsampleRows(cr_rows, row_count, width, factors.width, factors.height, cr_plane.ptr<unsigned char>(group));
+                                                                                          }
+                                                                                        }
+                                                                                      });
+  }
+
+  void ConvertPlanarYCbCrToBGR(const cv::Mat &y_plane, const cv::Mat &cb_plane, const cv::Mat &cr_plane, cv::Mat &image, const ChromaFormat format)
+  {
+    const comutils::TraceScope trace_scope("ConvertPlanarYCbCrToBGR");
+    assert(y_plane.type() == CV_8UC1);
+    const bool has_chroma = format != ChromaFormat::Format400;
+    if (has_chroma)
+    {
+      assert(cb_plane.type() == CV_8UC1 && cr_plane.type() == CV_8UC1);
+      assert(cb_plane.size() == GetChromaPlaneSize(y_plane.size(), format) && cr_plane.size() == cb_plane.size());
+    }
+    const int width = y_plane.cols;
+    const int height = y_plane.rows;
+    image.create(y_plane.size(), CV_8UC3);
+    const auto factors = GetChromaSubsamplingFactors(format);
+    const bool subsampled = has_chroma && format != ChromaFormat::Format444;
+    const auto &kernels = GetKernels();
+    const size_t group_count = (height + factors.height - 1) / factors.height; //Groups of all rows which share one row of chrominance samples
+    comutils::ParallelFor(group_count, GetRowGroupsPerTask(width, factors.height), [&](const size_t first_group, const size_t last_group)
+                                                                                      {
+                                                                                        std::vector<unsigned char> chroma_rows(subsampled || !has_chroma ? 2 * width : 0, 128); //Upsampled chrominance rows (or neutral chrominance)
+                                                                                        unsigned char * const cb_row = chroma_rows.data();
+                                                                                        unsigned char * const cr_row = cb_row + width;
+                                                                                        const int last_row = std::min<int>(last_group * factors.height, height);
+                                                                                        for (int y = first_group * factors.height; y < last_row; y++)
+                                                                                        {
+                                                                                          const unsigned char *cb = cb_row;
+                                                                                          const unsigned char *cr = cr_row;
+                                                                                          if (has_chroma)
+                                                                                          {
+                                                                                            const int chroma_y = y / factors.height;
+                                                                                            if (subsampled)
+                                                                                            {
+                                                                                              if (y % factors.height == 0) //Upsample only once per row of chrominance samples
+                                                                                              {
+                                                                                                UpsampleRow(cb_plane.ptr<unsigned char>(chroma_y), factors.width, width, cb_row);
+                                                                                                UpsampleRow(cr_plane.ptr<unsigned char>(chroma_y), factors.width, width, cr_row);
+                                                                                              }
+                                                                                            }
+                                                                                            else
+                                                                                            {
+                                                                                              cb = cb_plane.ptr<unsigned char>(chroma_y);
+                                                                                              cr = cr_plane.ptr<unsigned char>(chroma_y);
+                                                                                            }
+                                                                                          }
+                                                                                          kernels.ConvertRowToBGR(y_plane.ptr<unsigned char>(y), cb, cr, image.ptr<unsigned char>(y), width);
+                                                                                        }
+                                                                                      });
+  }
+
+  cv::Size GetDownscaledSize(const cv::Size &size, const unsigned int downscaling_factor)
+  {
+    assert(downscaling_factor >= 1);
+    const int factor = downscaling_factor;
+    return cv::Size((size.width + factor - 1) / factor, (size.height + factor - 1) / factor);
+  }
+
+  //Averages blocks of factor x factor pixels of a group of consecutive BGR rows into one output row
+  static void DownscaleRows(const cv::Mat &image, const int first_row, const int factor, std::vector<unsigned int> &sums, unsigned char * const output)
+  {
+    const int width = image.cols;
+    const int row_count = std::min(factor, image.rows - first_row);
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int row = 0; row < row_count; row++) //Accumulate whole rows first so that each pixel is only read once (in a loop the compiler can vectorise)
+    {
+      const unsigned char * const bgr = image.ptr<unsigned char>(first_row + row);
+      for (int i = 0; i < 3 * width; i++)
+        sums[i] += bgr[i];
+    }
+    const int output_width = (width + factor - 1) / factor;
+    for (int x = 0; x < output_width; x++)
+    {
+      const int first_x = x * factor;
+      const int column_count = std::min(factor, width - first_x);
+      const unsigned int sample_count = column_count * row_count;
+      for (int channel = 0; channel < 3; channel++)
+      {
+        unsigned int sum = 0;
+        for (int column = 0; column < column_count; column++)
+          sum += sums[3 * (first_x + column) + channel];
+        output[3 * x + channel] = static_cast<unsigned char>((sum + sample_count / 2) / sample_count);
+      }
+    }
+  }
+
+  void DecomposeBGRImage(const cv::Mat &image, cv::Mat &downscaled_image, cv::Mat (&components)[decomposition_component_count], const unsigned int downscaling_factor)
+  {
+    const comutils::TraceScope trace_scope("DecomposeBGRImage");
+    assert(image.type() == CV_8UC3);
+    const auto size = GetDownscaledSize(image.size(), downscaling_factor);
+    assert(downscaled_image.type() == CV_8UC3 && downscaled_image.size() == size);
+    for (const auto &component : components)
+      assert(component.type() == CV_8UC3 && component.size() == size);
+    const int factor = downscaling_factor;
+    const auto &kernels = GetKernels();
+    comutils::ParallelFor(size.height, GetRowGroupsPerTask(image.cols, factor), [&](const size_t first_row, const size_t last_row)
+                                                                                   {
+                                                                                     std::vector<unsigned int> sums(factor == 1 ? 0 : 3 * image.cols); //Column sums of the rows to be downscaled
+                                                                                     for (size_t y = first_row; y < last_row; y++)
+                                                                                     {
+                                                                                       unsigned char * const downscaled_row = downscaled_image.ptr<unsigned char>(y);
+                                                                                       if (factor == 1)
+                                                                                         std::copy_n(image.ptr<unsigned char>(y), 3 * size.width, downscaled_row);
+                                                                                       else
+                                                                                         DownscaleRows(image, y * factor, factor, sums, downscaled_row);
+                                                                                       unsigned char * const component_rows[] {components[0].ptr<unsigned char>(y), components[1].ptr<unsigned char>(y), components[2].ptr<unsigned char>(y),
+                                                                                                                               components[3].ptr<unsigned char>(y), components[4].ptr<unsigned char>(y), components[5].ptr<unsigned char>(y)};
+                                                                                       static_assert(comutils::arraysize(component_rows) == decomposition_component_count, "All components need to be written");
+                                                                                       kernels.DecomposeRow(downscaled_row, component_rows, size.width); //Read the (downscaled) row again while it is still in the cache
+                                                                                     }
+                                                                                   });
+  }
+}
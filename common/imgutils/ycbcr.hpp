@@ -0,0 +1,42 @@
+//YCbCr conversion and chrominance subsampling functions (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+
+#include <opencv2/core.hpp>
+
+namespace imgutils
+{
+  //Chrominance subsampling formats of planar YCbCr images
+  enum class ChromaFormat
+  {
+    Format444, //No subsampling
+    Format422, //Horizontal subsampling by a factor of 2
+    Format411, //Horizontal subsampling by a factor of 4
+    Format420, //Horizontal and vertical subsampling by a factor of 2
+    Format400 //No chrominance planes (luminance only)
+  };
+
+  //Returns the horizontal (width) and vertical (height) subsampling factors of the chrominance planes. For 4:0:0, 1x1 is returned.
+  cv::Size GetChromaSubsamplingFactors(const ChromaFormat format);
+  //Returns the size of each chrominance plane of an image with the specified (luminance) size. For 4:0:0, an empty size is returned.
+  cv::Size GetChromaPlaneSize(const cv::Size &size, const ChromaFormat format);
+  //Returns the exact number of bytes required to store all planes of an 8-bit YCbCr image with the specified size and format
+  size_t GetPlanarImageSize(const cv::Size &size, const ChromaFormat format);
+
+  //Converts an 8-bit BGR image into separate 8-bit Y, Cb and Cr planes in a single pass, subsampling the chrominance planes according to the specified format (by averaging). The planes are (re)allocated only if their sizes or types do not match. For 4:0:0, the chrominance planes are released.
+  void ConvertBGRToPlanarYCbCr(const cv::Mat &image, cv::Mat &y_plane, cv::Mat &cb_plane, cv::Mat &cr_plane, const ChromaFormat format);
+  //Converts separate 8-bit Y, Cb and Cr planes with the specified format into an 8-bit BGR image, repeating subsampled chrominance values. The image is (re)allocated only if its size or type does not match.
+  void ConvertPlanarYCbCrToBGR(const cv::Mat &y_plane, const cv::Mat &cb_plane, const cv::Mat &cr_plane, cv::Mat &image, const ChromaFormat format);
+
+  //Number of components written by DecomposeBGRImage
+  constexpr size_t decomposition_component_count = 6;
+
+  //Returns the size of an image after downscaling it by the specified integer factor. Incomplete blocks at the right and bottom borders yield one additional pixel each.
+  cv::Size GetDownscaledSize(const cv::Size &size, const unsigned int downscaling_factor);
+  //Splits an 8-bit BGR image into its R, G, B, Y, Cb and Cr components (in this order) in a single pass, downscaling it by the specified integer factor (by averaging). The downscaled image and its components are written into the specified 8-bit BGR matrices (with equal values in all channels for the components), which must already have the downscaled size, e.g., views into a larger image.
+  void DecomposeBGRImage(const cv::Mat &image, cv::Mat &downscaled_image, cv::Mat (&components)[decomposition_component_count], const unsigned int downscaling_factor = 1);
+}
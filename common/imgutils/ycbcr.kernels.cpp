@@ -0,0 +1,246 @@
+//YCbCr conversion and chrominance subsampling kernels (compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "ycbcr.kernels.hpp"
+
+namespace imgutils
+{
+  //Fixed-point coefficients (14 fractional bits) for full-range YCbCr as used by JPEG and cv::COLOR_BGR2YCrCb
+  static constexpr int coefficient_shift = 14;
+  static constexpr int rounding_offset = 1 << (coefficient_shift - 1);
+  static constexpr int chroma_offset = 128 << coefficient_shift;
+  static constexpr int r_to_y = 4899; //0.299
+  static constexpr int g_to_y = 9617; //0.587
+  static constexpr int b_to_y = 1868; //0.114
+  static constexpr int b_minus_y_to_cb = 9241; //0.564
+  static constexpr int r_minus_y_to_cr = 11682; //0.713
+  static constexpr int cr_to_r = 22987; //1.403
+  static constexpr int cr_to_g = -11698; //-0.714
+  static constexpr int cb_to_g = -5636; //-0.344
+  static constexpr int cb_to_b = 29049; //1.773
+  static_assert(r_to_y + g_to_y + b_to_y == 1 << coefficient_shift, "The luminance coefficients must add up to one");
+
+  //Clamps a value to [0;255] (cv::saturate_cast is not used since it is not specific to the dispatch target, see cpudispatch.hpp)
+  static inline unsigned char ClampToByte(const int value)
+  {
+    return static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+  }
+
+  static inline void ConvertPixelToYCbCr(const int b, const int g, const int r, unsigned char &y, unsigned char &cb, unsigned char &cr)
+  {
+    const int luma = (b * b_to_y + g * g_to_y + r * r_to_y + rounding_offset) >> coefficient_shift;
+    y = ClampToByte(luma);
+    cb = ClampToByte(((b - luma) * b_minus_y_to_cb + chroma_offset + rounding_offset) >> coefficient_shift);
+    cr = ClampToByte(((r - luma) * r_minus_y_to_cr + chroma_offset + rounding_offset) >> coefficient_shift);
+  }
+
+  static inline void ConvertPixelToBGR(const int y, const int cb, const int cr, unsigned char * const bgr)
+  {
+    const int centered_cb = cb - 128;
+    const int centered_cr = cr - 128;
+    bgr[0] = ClampToByte(y + ((centered_cb * cb_to_b + rounding_offset) >> coefficient_shift));
+    bgr[1] = ClampToByte(y + ((centered_cb * cb_to_g + centered_cr * cr_to_g + rounding_offset) >> coefficient_shift));
+    bgr[2] = ClampToByte(y + ((centered_cr * cr_to_r + rounding_offset) >> coefficient_shift));
+  }
+
+#if CV_SIMD
+  //Expands 8-bit values into four vectors of 32-bit values
+  static inline void ExpandTo32Bits(const cv::v_uint8 &values, cv::v_int32 (&expanded_values)[4])
+  {
+    cv::v_uint16 low, high;
+    cv::v_expand(values, low, high);
+    cv::v_uint32 parts[4];
+    cv::v_expand(low, parts[0], parts[1]);
+    cv::v_expand(high, parts[2], parts[3]);
+    for (size_t i = 0; i < 4; i++)
+      expanded_values[i] = cv::v_reinterpret_as_s32(parts[i]);
+  }
+
+  //Packs four vectors of 32-bit values into 8-bit values with saturation
+  static inline cv::v_uint8 PackTo8Bits(const cv::v_int32 (&values)[4])
+  {
+    return cv::v_pack_u(cv::v_pack(values[0], values[1]), cv::v_pack(values[2], values[3]));
+  }
+
+  //Calculates the rounded average of four 8-bit values each
+  static inline cv::v_uint8 Average(const cv::v_uint8 &a, const cv::v_uint8 &b, const cv::v_uint8 &c, const cv::v_uint8 &d)
+  {
+    cv::v_uint16 a_low, a_high, b_low, b_high, c_low, c_high, d_low, d_high;
+    cv::v_expand(a, a_low, a_high);
+    cv::v_expand(b, b_low, b_high);
+    cv::v_expand(c, c_low, c_high);
+    cv::v_expand(d, d_low, d_high);
+    const cv::v_uint16 rounding = cv::vx_setall_u16(2);
+    const cv::v_uint16 low = cv::v_shr<2>(cv::v_add(cv::v_add(cv::v_add(a_low, b_low), cv::v_add(c_low, d_low)), rounding));
+    const cv::v_uint16 high = cv::v_shr<2>(cv::v_add(cv::v_add(cv::v_add(a_high, b_high), cv::v_add(c_high, d_high)), rounding));
+    return cv::v_pack(low, high);
+  }
+#endif
+
+#if CV_SIMD
+  //Converts vectors of 8-bit B, G and R values into vectors of 8-bit Y, Cb and Cr values
+  static inline void ConvertPixelsToYCbCr(const cv::v_uint8 &b8, const cv::v_uint8 &g8, const cv::v_uint8 &r8, cv::v_uint8 &y8, cv::v_uint8 &cb8, cv::v_uint8 &cr8)
+  {
+    const cv::v_int32 v_r_to_y = cv::vx_setall_s32(r_to_y), v_g_to_y = cv::vx_setall_s32(g_to_y), v_b_to_y = cv::vx_setall_s32(b_to_y);
+    const cv::v_int32 v_b_minus_y_to_cb = cv::vx_setall_s32(b_minus_y_to_cb), v_r_minus_y_to_cr = cv::vx_setall_s32(r_minus_y_to_cr);
+    const cv::v_int32 v_rounding_offset = cv::vx_setall_s32(rounding_offset), v_chroma_offset = cv::vx_setall_s32(chroma_offset + rounding_offset);
+    cv::v_int32 b[4], g[4], r[4];
+    ExpandTo32Bits(b8, b);
+    ExpandTo32Bits(g8, g);
+    ExpandTo32Bits(r8, r);
+    cv::v_int32 luma[4], blue_difference[4], red_difference[4];
+    for (size_t i = 0; i < 4; i++)
+    {
+      luma[i] = cv::v_shr<coefficient_shift>(cv::v_add(cv::v_add(cv::v_mul(b[i], v_b_to_y), cv::v_mul(g[i], v_g_to_y)), cv::v_add(cv::v_mul(r[i], v_r_to_y), v_rounding_offset)));
+      blue_difference[i] = cv::v_shr<coefficient_shift>(cv::v_add(cv::v_mul(cv::v_sub(b[i], luma[i]), v_b_minus_y_to_cb), v_chroma_offset));
+      red_difference[i] = cv::v_shr<coefficient_shift>(cv::v_add(cv::v_mul(cv::v_sub(r[i], luma[i]), v_r_minus_y_to_cr), v_chroma_offset));
+    }
+    y8 = PackTo8Bits(luma);
+    cb8 = PackTo8Bits(blue_difference);
+    cr8 = PackTo8Bits(red_difference);
+  }
+#endif
+
+  static void ConvertRowToYCbCr(const unsigned char * const bgr, unsigned char * const y, unsigned char * const cb, unsigned char * const cr, const int width)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    for (; x <= width - lanes; x += lanes)
+    {
+      cv::v_uint8 b8, g8, r8;
+      cv::v_load_deinterleave(bgr + 3 * x, b8, g8, r8);
+      cv::v_uint8 y8, cb8, cr8;
+      ConvertPixelsToYCbCr(b8, g8, r8, y8, cb8, cr8);
+      cv::v_store(y + x, y8);
+      cv::v_store(cb + x, cb8);
+      cv::v_store(cr + x, cr8);
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+      ConvertPixelToYCbCr(bgr[3 * x], bgr[3 * x + 1], bgr[3 * x + 2], y[x], cb[x], cr[x]);
+  }
+
+  static void ConvertRowToBGR(const unsigned char * const y, const unsigned char * const cb, const unsigned char * const cr, unsigned char * const bgr, const int width)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    const cv::v_int32 v_cr_to_r = cv::vx_setall_s32(cr_to_r), v_cr_to_g = cv::vx_setall_s32(cr_to_g), v_cb_to_g = cv::vx_setall_s32(cb_to_g), v_cb_to_b = cv::vx_setall_s32(cb_to_b);
+    const cv::v_int32 v_center = cv::vx_setall_s32(128), v_rounding_offset = cv::vx_setall_s32(rounding_offset);
+    for (; x <= width - lanes; x += lanes)
+    {
+      cv::v_int32 luma[4], blue_difference[4], red_difference[4];
+      ExpandTo32Bits(cv::vx_load(y + x), luma);
+      ExpandTo32Bits(cv::vx_load(cb + x), blue_difference);
+      ExpandTo32Bits(cv::vx_load(cr + x), red_difference);
+      cv::v_int32 b[4], g[4], r[4];
+      for (size_t i = 0; i < 4; i++)
+      {
+        const cv::v_int32 centered_cb = cv::v_sub(blue_difference[i], v_center);
+        const cv::v_int32 centered_cr = cv::v_sub(red_difference[i], v_center);
+        b[i] = cv::v_add(luma[i], cv::v_shr<coefficient_shift>(cv::v_add(cv::v_mul(centered_cb, v_cb_to_b), v_rounding_offset)));
+        g[i] = cv::v_add(luma[i], cv::v_shr<coefficient_shift>(cv::v_add(cv::v_add(cv::v_mul(centered_cb, v_cb_to_g), cv::v_mul(centered_cr, v_cr_to_g)), v_rounding_offset)));
+        r[i] = cv::v_add(luma[i], cv::v_shr<coefficient_shift>(cv::v_add(cv::v_mul(centered_cr, v_cr_to_r), v_rounding_offset)));
+      }
+      cv::v_store_interleave(bgr + 3 * x, PackTo8Bits(b), PackTo8Bits(g), PackTo8Bits(r));
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+      ConvertPixelToBGR(y[x], cb[x], cr[x], bgr + 3 * x);
+  }
+
+  static void DownsampleRows(const unsigned char * const rows, const int row_count, const int width, const int horizontal_factor, const int vertical_factor, unsigned char * const output)
+  {
+    const int output_width = (width + horizontal_factor - 1) / horizontal_factor;
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    if (row_count == vertical_factor) //Complete blocks only
+    {
+      if (horizontal_factor == 2 && vertical_factor == 1)
+      {
+        for (; horizontal_factor * (x + lanes) <= width; x += lanes)
+        {
+          cv::v_uint8 even, odd;
+          cv::v_load_deinterleave(rows + 2 * x, even, odd);
+          cv::v_store(output + x, cv::v_avg(even, odd));
+        }
+      }
+      else if (horizontal_factor == 4 && vertical_factor == 1)
+      {
+        for (; horizontal_factor * (x + lanes) <= width; x += lanes)
+        {
+          cv::v_uint8 a, b, c, d;
+          cv::v_load_deinterleave(rows + 4 * x, a, b, c, d);
+          cv::v_store(output + x, Average(a, b, c, d));
+        }
+      }
+      else if (horizontal_factor == 2 && vertical_factor == 2)
+      {
+        for (; horizontal_factor * (x + lanes) <= width; x += lanes)
+        {
+          cv::v_uint8 top_even, top_odd, bottom_even, bottom_odd;
+          cv::v_load_deinterleave(rows + 2 * x, top_even, top_odd);
+          cv::v_load_deinterleave(rows + width + 2 * x, bottom_even, bottom_odd);
+          cv::v_store(output + x, Average(top_even, top_odd, bottom_even, bottom_odd));
+        }
+      }
+      cv::vx_cleanup();
+    }
+#endif
+    for (; x < output_width; x++) //Remaining samples and incomplete blocks at the borders
+    {
+      const int first_x = x * horizontal_factor;
+      const int column_count = horizontal_factor < width - first_x ? horizontal_factor : width - first_x;
+      int sum = 0;
+      for (int row = 0; row < row_count; row++)
+      {
+        for (int column = 0; column < column_count; column++)
+          sum += rows[row * width + first_x + column];
+      }
+      const int sample_count = column_count * row_count;
+      output[x] = static_cast<unsigned char>((sum + sample_count / 2) / sample_count);
+    }
+  }
+
+  static void DecomposeRow(const unsigned char * const bgr, unsigned char * const (&components)[ycbcr_kernel_component_count], const int width)
+  {
+    int x = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+    for (; x <= width - lanes; x += lanes)
+    {
+      cv::v_uint8 b8, g8, r8;
+      cv::v_load_deinterleave(bgr + 3 * x, b8, g8, r8);
+      cv::v_uint8 y8, cb8, cr8;
+      ConvertPixelsToYCbCr(b8, g8, r8, y8, cb8, cr8);
+      const cv::v_uint8 values[] {r8, g8, b8, y8, cb8, cr8};
+      for (size_t i = 0; i < ycbcr_kernel_component_count; i++)
+        cv::v_store_interleave(components[i] + 3 * x, values[i], values[i], values[i]);
+    }
+    cv::vx_cleanup();
+#endif
+    for (; x < width; x++)
+    {
+      const unsigned char * const pixel = bgr + 3 * x;
+      unsigned char y, cb, cr;
+      ConvertPixelToYCbCr(pixel[0], pixel[1], pixel[2], y, cb, cr);
+      const unsigned char values[] {pixel[2], pixel[1], pixel[0], y, cb, cr};
+      for (size_t i = 0; i < ycbcr_kernel_component_count; i++)
+      {
+        for (int channel = 0; channel < 3; channel++)
+          components[i][3 * x + channel] = values[i];
+      }
+    }
+  }
+
+  const YCbCrKernels CPU_DISPATCH_NAME(ycbcr_kernels) {ConvertRowToYCbCr, ConvertRowToBGR, DownsampleRows, DecomposeRow};
+}
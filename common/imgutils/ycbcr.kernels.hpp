@@ -0,0 +1,30 @@
+//YCbCr conversion and chrominance subsampling kernels (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+
+#include "cpudispatch.hpp"
+
+namespace imgutils
+{
+  //Number of components written by the DecomposeRow kernel (R, G, B, Y, Cb and Cr)
+  constexpr size_t ycbcr_kernel_component_count = 6;
+
+  //Row kernels for YCbCr conversions, compiled once per dispatch target (see cpudispatch.hpp). Kernels do not use OpenCV types so that only the intrinsics are compiled with the instruction sets of the target.
+  struct YCbCrKernels
+  {
+    //Converts a row of 8-bit BGR pixels into separate rows of 8-bit Y, Cb and Cr samples
+    void (*ConvertRowToYCbCr)(const unsigned char * const bgr, unsigned char * const y, unsigned char * const cb, unsigned char * const cr, const int width);
+    //Converts separate rows of 8-bit Y, Cb and Cr samples into a row of 8-bit BGR pixels
+    void (*ConvertRowToBGR)(const unsigned char * const y, const unsigned char * const cb, const unsigned char * const cr, unsigned char * const bgr, const int width);
+    //Averages blocks of horizontal_factor x row_count samples of a group of consecutive rows (width samples each) into one output row. row_count may be smaller than vertical_factor at the bottom border.
+    void (*DownsampleRows)(const unsigned char * const rows, const int row_count, const int width, const int horizontal_factor, const int vertical_factor, unsigned char * const output);
+    //Writes the R, G, B, Y, Cb and Cr components of a BGR row into separate BGR rows with equal values in all channels
+    void (*DecomposeRow)(const unsigned char * const bgr, unsigned char * const (&components)[ycbcr_kernel_component_count], const int width);
+  };
+
+  CPU_DISPATCH_DECLARE(YCbCrKernels, ycbcr_kernels);
+}
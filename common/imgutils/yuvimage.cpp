@@ -0,0 +1,200 @@
+//Planar YCbCr image class
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "yuvimage.hpp"
+
+namespace imgutils
+{
+  static constexpr size_t max_planes = 3;
+
+  static size_t AlignUp(const size_t value, const size_t alignment)
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  //Memory layout of a single plane within the buffer of an image
+  struct PlaneLayout
+  {
+    cv::Size size; //Visible size
+    cv::Size border; //Padding on each side
+    size_t left; //Offset of the first visible pixel in each row (aligned)
+    size_t stride;
+    size_t rows;
+
+    PlaneLayout(const cv::Size &size, const cv::Size &factors, const unsigned int padding)
+     : size(size),
+       border((padding + factors.width - 1) / factors.width, (padding + factors.height - 1) / factors.height),
+       left(AlignUp(border.width, YUVImage::alignment)),
+       stride(AlignUp(left + size.width + border.width, YUVImage::alignment)),
+       rows(size.height + 2 * border.height) { }
+
+    size_t GetByteSize() const
+    {
+      return stride * rows;
+    }
+  };
+
+  YUVImage::YUVImage(comutils::BufferPool &pool)
+   : pool(&pool),
+     buffer_size(0),
+     format(ChromaFormat::Format400),
+     padding(0) { }
+
+  YUVImage::YUVImage(const cv::Size &size, const ChromaFormat format, const unsigned int padding, comutils::BufferPool &pool)
+   : YUVImage(pool)
+  {
+    Create(size, format, padding);
+  }
+
+  YUVImage::YUVImage(const cv::Mat &image, const ChromaFormat format, const unsigned int padding, comutils::BufferPool &pool)
+   : YUVImage(pool)
+  {
+    this->padding = padding;
+    ConvertFrom(image, format);
+  }
+
+  void YUVImage::Create(const cv::Size &size, const ChromaFormat format, const unsigned int padding)
+  {
+    if (buffer && size == this->size && format == this->format && padding == this->padding) //Nothing changes
+      return;
+    const size_t plane_count = format == ChromaFormat::Format400 ? 1 : max_planes;
+    const PlaneLayout luma_layout(size, cv::Size(1, 1), padding);
+    const PlaneLayout chroma_layout(GetChromaPlaneSize(size, format), GetChromaSubsamplingFactors(format), padding);
+    const size_t required_size = luma_layout.GetByteSize() + (plane_count - 1) * chroma_layout.GetByteSize();
+    if (!buffer || buffer_size < required_size)
+    {
+      buffer.reset(); //Return the old buffer to the pool first so that it can be reused if possible
+      buffer = pool->Allocate(required_size);
+      buffer_size = required_size;
+    }
+    this->size = size;
+    this->format = format;
+    this->padding = padding;
+    unsigned char *plane_data = buffer.get();
+    for (size_t i = 0; i < max_planes; i++)
+    {
+      if (i >= plane_count)
+      {
+        padded_planes[i] = cv::Mat();
+        planes[i] = cv::Mat();
+        continue;
+      }
+      const auto &layout = i == 0 ? luma_layout : chroma_layout;
+      const cv::Mat whole_rows(layout.rows, layout.stride, CV_8UC1, plane_data, layout.stride);
+      padded_planes[i] = whole_rows(cv::Rect(layout.left - layout.border.width, 0, layout.size.width + 2 * layout.border.width, layout.rows));
+      planes[i] = whole_rows(cv::Rect(cv::Point(layout.left, layout.border.height), layout.size));
+      assert(reinterpret_cast<uintptr_t>(planes[i].data) % alignment == 0);
+      plane_data += layout.GetByteSize();
+    }
+  }
+
+  void YUVImage::Release()
+  {
+    for (size_t i = 0; i < max_planes; i++)
+    {
+      padded_planes[i] = cv::Mat();
+      planes[i] = cv::Mat();
+    }
+    buffer.reset();
+    buffer_size = 0;
+    size = cv::Size();
+  }
+
+  bool YUVImage::IsEmpty() const
+  {
+    return size.area() == 0;
+  }
+
+  cv::Size YUVImage::GetSize() const
+  {
+    return size;
+  }
+
+  ChromaFormat YUVImage::GetFormat() const
+  {
+    return format;
+  }
+
+  unsigned int YUVImage::GetPadding() const
+  {
+    return padding;
+  }
+
+  size_t YUVImage::GetPlaneCount() const
+  {
+    return format == ChromaFormat::Format400 ? 1 : max_planes;
+  }
+
+  size_t YUVImage::GetByteSize() const
+  {
+    return GetPlanarImageSize(size, format);
+  }
+
+  cv::Mat YUVImage::GetPlane(const Plane plane) const
+  {
+    const auto index = static_cast<size_t>(plane);
+    assert(index < GetPlaneCount());
+    return planes[index];
+  }
+
+  cv::Mat YUVImage::GetPaddedPlane(const Plane plane) const
+  {
+    const auto index = static_cast<size_t>(plane);
+    assert(index < GetPlaneCount());
+    return padded_planes[index];
+  }
+
+  void YUVImage::ExtendBorders()
+  {
+    for (size_t i = 0; i < GetPlaneCount(); i++)
+    {
+      cv::Mat &padded_plane = padded_planes[i];
+      const cv::Mat &plane = planes[i];
+      if (plane.empty())
+        continue;
+      cv::Size whole_size;
+      cv::Point offset;
+      plane.locateROI(whole_size, offset);
+      cv::Point padded_offset;
+      padded_plane.locateROI(whole_size, padded_offset);
+      const int left = offset.x - padded_offset.x;
+      const int top = offset.y - padded_offset.y;
+      const int right = padded_plane.cols - plane.cols - left;
+      for (int y = 0; y < plane.rows; y++) //Repeat the left-most and right-most pixels of each row
+      {
+        unsigned char * const row = padded_plane.ptr<unsigned char>(top + y);
+        std::memset(row, row[left], left);
+        std::memset(row + left + plane.cols, row[left + plane.cols - 1], right);
+      }
+      const int bottom = padded_plane.rows - plane.rows - top;
+      for (int y = 0; y < top; y++) //Repeat the top-most and bottom-most (extended) rows
+        std::memcpy(padded_plane.ptr<unsigned char>(y), padded_plane.ptr<unsigned char>(top), padded_plane.cols);
+      for (int y = 0; y < bottom; y++)
+        std::memcpy(padded_plane.ptr<unsigned char>(top + plane.rows + y), padded_plane.ptr<unsigned char>(top + plane.rows - 1), padded_plane.cols);
+    }
+  }
+
+  void YUVImage::ConvertFrom(const cv::Mat &image, const ChromaFormat format)
+  {
+    assert(image.type() == CV_8UC3 || (image.type() == CV_8UC1 && format == ChromaFormat::Format400));
+    Create(image.size(), format, padding);
+    if (image.type() == CV_8UC1)
+      image.copyTo(planes[0]); //Sizes match, so the data is copied into the existing plane
+    else
+    {
+      cv::Mat y_plane = planes[0], cb_plane = planes[1], cr_plane = planes[2]; //Use copies of the headers so that the conversion cannot replace the planes
+      ConvertBGRToPlanarYCbCr(image, y_plane, cb_plane, cr_plane, format);
+      assert(y_plane.data == planes[0].data);
+    }
+  }
+
+  void YUVImage::ConvertTo(cv::Mat &image) const
+  {
+    ConvertPlanarYCbCrToBGR(planes[0], planes[1], planes[2], image, format);
+  }
+}
@@ -0,0 +1,79 @@
+//Planar YCbCr image class (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+
+#include <opencv2/core.hpp>
+
+#include "bufpool.hpp"
+#include "ycbcr.hpp"
+
+namespace imgutils
+{
+  //Planes of a YCbCr image
+  enum class Plane { Y, Cb, Cr };
+
+  //Planar 8-bit YCbCr image with aligned rows and padded borders whose memory is taken from a buffer pool. The planes are accessible as matrix headers without copying.
+  class YUVImage
+  {
+    public:
+      //Alignment of the first visible pixel and the stride of each row of each plane in bytes
+      static constexpr size_t alignment = comutils::BufferPool::alignment;
+      //Number of padding pixels around the luminance plane by default
+      static constexpr unsigned int default_padding = 16;
+
+      //Creates an empty image whose memory will be taken from the specified pool
+      YUVImage(comutils::BufferPool &pool = comutils::BufferPool::GetDefault());
+      //Creates an image with the specified size, format and padding (in luminance pixels on each side) whose memory is taken from the specified pool. The chrominance padding is scaled according to the subsampling.
+      YUVImage(const cv::Size &size, const ChromaFormat format, const unsigned int padding = default_padding, comutils::BufferPool &pool = comutils::BufferPool::GetDefault());
+      //Creates an image with the specified format and padding from an 8-bit BGR or gray-scale image (see ConvertFrom)
+      YUVImage(const cv::Mat &image, const ChromaFormat format, const unsigned int padding = default_padding, comutils::BufferPool &pool = comutils::BufferPool::GetDefault());
+      YUVImage(const YUVImage &original) = delete; //Explicitly delete the copy constructor to avoid accidental copies of the planes
+      YUVImage &operator=(const YUVImage &original) = delete;
+      YUVImage(YUVImage &&original) = default;
+      YUVImage &operator=(YUVImage &&original) = default;
+
+      //Changes the size, format and padding of the image. The memory is only replaced if it is too small. The pixel values are undefined afterwards.
+      void Create(const cv::Size &size, const ChromaFormat format, const unsigned int padding = default_padding);
+      //Releases the memory of the image, returning it to the pool
+      void Release();
+
+      //Returns true if the image has no pixels
+      bool IsEmpty() const;
+      //Returns the size of the luminance plane
+      cv::Size GetSize() const;
+      //Returns the chrominance format
+      ChromaFormat GetFormat() const;
+      //Returns the number of padding pixels around the luminance plane
+      unsigned int GetPadding() const;
+      //Returns the number of planes (one for 4:0:0 images, three otherwise)
+      size_t GetPlaneCount() const;
+      //Returns the exact number of bytes required to store the visible pixels of all planes (without padding and alignment)
+      size_t GetByteSize() const;
+
+      //Returns a matrix header of the visible part of the specified plane. Writing into it changes the image.
+      cv::Mat GetPlane(const Plane plane) const;
+      //Returns a matrix header of the specified plane including its padded borders. Writing into it changes the image.
+      cv::Mat GetPaddedPlane(const Plane plane) const;
+      //Fills the padded borders of all planes by repeating the outermost visible pixels
+      void ExtendBorders();
+
+      //Converts an 8-bit BGR image into an image with the specified format, recreating this image if its size or format differs (see Create). 8-bit gray-scale images can only be converted into 4:0:0 images.
+      void ConvertFrom(const cv::Mat &image, const ChromaFormat format);
+      //Converts this image into an 8-bit BGR image. The BGR image is (re)allocated only if its size or type does not match.
+      void ConvertTo(cv::Mat &image) const;
+
+    private:
+      comutils::BufferPool *pool;
+      comutils::BufferPool::Buffer buffer;
+      size_t buffer_size;
+      cv::Size size;
+      ChromaFormat format;
+      unsigned int padding;
+      cv::Mat padded_planes[3];
+      cv::Mat planes[3];
+  };
+}
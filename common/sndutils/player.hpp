@@ -1,25 +1,30 @@
 //Audio playback helper class (header)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <thread>
 
-#include <ao/ao.h>
-
 #include "wavegen.hpp"
+#include "ringbuf.hpp"
+#include "sink.hpp"
 
 namespace sndutils
 {
-  //Plays back raw audio streams of base type T on the default playback device
+  //Plays back raw audio streams of base type T on the default playback device or another sink. Samples are rendered in advance by one thread and fed to the sink by another one so that rendering spikes do not interrupt playback.
   template<typename T>
   class AudioPlayer
   {  
     public:
-      //Constructs a new instance of AudioPlayer with the given playback device parameters. Make sure that the used device is configured accordingly.
-      AudioPlayer(const unsigned int sampling_rate = 48000, const size_t number_of_channels = 2);
+      //Constructs a new instance of AudioPlayer with the given playback device parameters. Make sure that the used device is configured accordingly. Samples are passed to the device in periods of period_size samples per channel. Up to period_count periods are rendered in advance, which determines how long rendering may stall without interrupting playback, but also how long it takes for changes of the generator's parameters to become audible.
+      AudioPlayer(const unsigned int sampling_rate = 48000, const size_t number_of_channels = 2, const size_t period_size = 1000, const size_t period_count = 4);
+      //Constructs a new instance of AudioPlayer which writes to the specified sink instead of the default playback device. The sink must accept samples of type T. Non-real-time sinks are written to as fast as possible.
+      AudioPlayer(AudioSink &sink, const size_t period_size = 1000, const size_t period_count = 4);
       ~AudioPlayer();
       
       //Plays back the wave form produced by the specified generator asynchronously until Stop() is called
@@ -34,14 +39,42 @@ namespace sndutils
       bool IsPlaying() const;
       //Returns whether there is playback at the moment
       bool IsPlayingBack() const;
+      
+      //Returns how often playback has been interrupted since it has been started because no rendered samples were available
+      size_t GetUnderrunCount() const;
+      //Returns the estimated time in seconds until samples which are rendered now are played back, i.e., the time until changes of the generator's parameters become audible
+      double GetEstimatedLatency() const;
+      
+      //Copies the rendered samples (of one channel) into the specified ring buffer in addition to playing them back, e.g., for analysis. Samples which do not fit into the ring buffer are dropped so that rendering never waits for the buffer's consumer. The ring buffer must not be destroyed before playback has been stopped. A null pointer removes the tap. The tap can only be changed when not playing.
+      void SetTap(comutils::RingBuffer<T> * const tap);
     
     private:
-      ao_sample_format sample_format;
-      ao_device *playback_device;
+      std::unique_ptr<AudioSink> owned_sink; //Only set when playing back on the default device
+      AudioSink &sink;
+      const size_t period_size; //In samples per channel
+      const size_t period_count;
+      const size_t frame_size; //In bytes (one sample for each channel)
+      comutils::RingBuffer<unsigned char> rendered_samples; //Samples in the sink's format which have been rendered, but not played back yet
       std::atomic_bool playing;
       std::atomic_bool paused;
-      std::thread worker;
+      std::atomic<size_t> underrun_count;
+      comutils::RingBuffer<T> *tap;
+      std::mutex wait_mutex; //Only used for waiting, not for accessing the rendered samples
+      std::condition_variable samples_rendered;
+      std::condition_variable samples_played;
+      std::thread renderer;
+      std::thread feeder;
+      
+      AudioPlayer(std::unique_ptr<AudioSink> owned_sink, AudioSink * const external_sink, const size_t period_size, const size_t period_count);
+      
+      void RenderSamples(comutils::WaveFormGenerator<T> &generator);
+      void FeedSink();
+      void Notify(std::condition_variable &condition);
   };
+  
+  //Renders frame_count samples per channel of the wave form produced by the specified generator into the specified sink on the calling thread in periods of period_size samples per channel. This is as fast as possible for non-real-time sinks, e.g., for writing files or benchmarking.
+  template<typename T>
+  void Render(comutils::WaveFormGenerator<T> &generator, AudioSink &sink, const size_t frame_count, const size_t period_size = 1000);
 }
 
 #include "player.impl.hpp"
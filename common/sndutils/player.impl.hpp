@@ -1,14 +1,19 @@
 //Audio playback helper class (template implementation)
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <cassert>
 #include <stdexcept>
+#include <algorithm>
 #include <atomic>
+#include <functional>
 #include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "common.hpp"
+#include "trace.hpp"
+#include "player.kernels.hpp"
 
 //#include "player.hpp"
 
@@ -18,12 +23,14 @@ namespace sndutils
   class WaveFormConverter
   {
     public:
-      WaveFormConverter(comutils::WaveFormGenerator<T> &generator, const size_t number_of_channels)
-       : generator(generator), number_of_channels(number_of_channels),
+      WaveFormConverter(comutils::WaveFormGenerator<T> &generator, const size_t number_of_channels, const size_t units_per_buffer)
+       : generator(generator), number_of_channels(number_of_channels), units_per_buffer(units_per_buffer),
          unit_size(sample_size * number_of_channels),
-         buffer_size(units_per_buffer * unit_size)
+         buffer_size(units_per_buffer * unit_size),
+         samples(units_per_buffer)
       {
         assert(number_of_channels > 0);
+        assert(units_per_buffer > 0);
         
         buffer = new unsigned char[buffer_size];
       }
@@ -39,12 +46,33 @@ namespace sndutils
       {
         buffer = this->buffer;
         static_assert(sizeof(unsigned char) == 1, "char must be one byte in size");
+        static_assert(std::is_integral<T>(), "T (WaveFormGenerator sample type) must be an integral type");
+        static_assert(sizeof(Lane) == sizeof(T), "Only 8-bit, 16-bit and 32-bit types are supported");
+        generator.GenerateBlock(samples.data(), units_per_buffer); //One call for the whole buffer instead of one per sample
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        //The samples are already in the device's byte order, so they only need to be copied to all channels
+        const auto * const values = reinterpret_cast<const Lane*>(samples.data());
+        auto * const output = reinterpret_cast<Lane*>(buffer);
+        switch (number_of_channels)
+        {
+          case 1:
+            std::copy(values, values + units_per_buffer, output);
+            break;
+          case 2:
+          case 3:
+          case 4:
+            GetReplicationKernel(number_of_channels)(values, output, units_per_buffer);
+            break;
+          default:
+            for (size_t unit = 0; unit < units_per_buffer; unit++)
+              std::fill_n(output + unit * number_of_channels, number_of_channels, values[unit]);
+        }
+#else
         for (size_t unit = 0; unit < units_per_buffer; unit++)
         {
-          static_assert(std::is_integral<T>(), "T (WaveFormGenerator sample type) must be an integral type");
           using U = typename std::conditional<std::is_signed<T>::value, long, unsigned long>::type; //Use long for signed chars, ints etc. and unsigned long for the rest
           static_assert(sizeof(T) <= sizeof(U), "T (WaveFormGenerator sample type) cannot be larger than (unsigned) long"); //Since (unsigned) long is used for shifting below, the type's size has to be smaller than that of an (unsigned) long
-          const auto current_value = static_cast<U>(generator.GetNextSample());
+          const auto current_value = static_cast<U>(samples[unit]);
           for (size_t channel = 0; channel < number_of_channels; channel++) //Fill all channels with the same samples
           {
             for (size_t sample_byte = 0; sample_byte < sample_size; sample_byte++)
@@ -53,39 +81,136 @@ namespace sndutils
             }
           }
         }
+#endif
         return buffer_size;
       }
       
+      //Returns the samples of the last buffer before conversion, i.e., of one channel
+      const T *GetSamples() const
+      {
+        return samples.data();
+      }
+      
       //Sample size in bytes
       static constexpr size_t sample_size = sizeof(T);
     
     private:
-      static constexpr size_t units_per_buffer = 1000; //Each buffer will be filled with 1000 samples for each channel
-      
       comutils::WaveFormGenerator<T> &generator;
       const size_t number_of_channels;
+      const size_t units_per_buffer; //Number of samples per channel in each buffer
       const size_t unit_size;
       const size_t buffer_size;
       unsigned char *buffer;
+      std::vector<T> samples; //Samples of the current buffer before conversion
+      
+      using Lane = typename std::conditional<sizeof(T) == 1, unsigned char, typename std::conditional<sizeof(T) == 2, unsigned short, unsigned int>::type>::type; //Unsigned type of the same size as T. The signedness is irrelevant for copying.
+      
+      //Returns the kernel which copies each value to the specified number of consecutive (interleaved) channels (two to four)
+      static auto GetReplicationKernel(const size_t number_of_channels)
+      {
+        assert(number_of_channels >= 2 && number_of_channels <= 4);
+        static const SampleConversionKernels &kernels = CPU_DISPATCH_SELECT(sample_conversion_kernels);
+        if constexpr (sizeof(Lane) == 1)
+          return kernels.ReplicateChannels8[number_of_channels - 2];
+        else if constexpr (sizeof(Lane) == 2)
+          return kernels.ReplicateChannels16[number_of_channels - 2];
+        else
+          return kernels.ReplicateChannels32[number_of_channels - 2];
+      }
   };
 
   template<typename T>
-  AudioPlayer<T>::AudioPlayer(const unsigned int sampling_rate, const size_t number_of_channels) : playing(false), paused(false)
+  AudioPlayer<T>::AudioPlayer(const unsigned int sampling_rate, const size_t number_of_channels, const size_t period_size, const size_t period_count)
+   : AudioPlayer(std::make_unique<LiveAudioSink>(SampleFormat {sampling_rate, number_of_channels, WaveFormConverter<T>::sample_size}), nullptr, period_size, period_count) { }
+
+  template<typename T>
+  AudioPlayer<T>::AudioPlayer(AudioSink &sink, const size_t period_size, const size_t period_count)
+   : AudioPlayer(nullptr, &sink, period_size, period_count) { }
+
+  template<typename T>
+  AudioPlayer<T>::AudioPlayer(std::unique_ptr<AudioSink> owned_sink, AudioSink * const external_sink, const size_t period_size, const size_t period_count)
+   : owned_sink(std::move(owned_sink)), sink(external_sink ? *external_sink : *this->owned_sink),
+     period_size(period_size), period_count(period_count),
+     frame_size(sink.GetFormat().GetFrameSize()),
+     rendered_samples(period_count * period_size * frame_size),
+     playing(false), paused(false), underrun_count(0), tap(nullptr)
   {
-    assert(sampling_rate > 0);
+    assert(period_size > 0);
+    assert(period_count > 0);
     
     constexpr size_t sample_bits = 8 * WaveFormConverter<T>::sample_size;
     static_assert(sample_bits == 8 || sample_bits == 16 || sample_bits == 32, "Only 8-bit, 16-bit and 32-bit types are supported"); //TODO: Support 24 bit types?
-    sample_format.bits = sample_bits;
-    sample_format.channels = static_cast<int>(number_of_channels);
-    sample_format.rate = static_cast<int>(sampling_rate);
-    sample_format.byte_format = AO_FMT_LITTLE; //Use little endian
-    sample_format.matrix = nullptr;
-    
-    ao_initialize();
-    const int driver_id = ao_default_driver_id();
-    if (!(playback_device = ao_open_live(driver_id, &sample_format, nullptr)))
-      throw std::runtime_error("Could not open playback device");
+    if (sink.GetFormat().sample_size != WaveFormConverter<T>::sample_size)
+      throw std::runtime_error("The sink's sample size does not match the sample type");
+  }
+
+  template<typename T>
+  void AudioPlayer<T>::Notify(std::condition_variable &condition)
+  {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex); //Avoid missed wake-ups of threads which are about to wait
+    }
+    condition.notify_one();
+  }
+
+  template<typename T>
+  void AudioPlayer<T>::RenderSamples(comutils::WaveFormGenerator<T> &generator)
+  {
+    comutils::TraceScope::SetThreadName("Audio rendering");
+    WaveFormConverter<T> converter(generator, sink.GetFormat().number_of_channels, period_size);
+    const size_t period_bytes = period_size * frame_size;
+    while (playing)
+    {
+      {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        samples_played.wait(lock, [this, period_bytes]()
+                                                      {
+                                                        return !playing || rendered_samples.GetReadableCount() + period_bytes <= period_count * period_bytes; //The ring buffer may be larger since its capacity is a power of two
+                                                      });
+      }
+      if (!playing)
+        break;
+      unsigned char *buffer;
+      size_t buffer_size;
+      {
+        const comutils::TraceScope trace_scope("GetNextSampleBuffer");
+        buffer_size = converter.GetNextSampleBuffer(buffer);
+      }
+      assert(buffer_size == period_bytes);
+      if (tap)
+        tap->Write(converter.GetSamples(), period_size); //Drops samples when the tap is full
+      [[maybe_unused]] const size_t written_size = rendered_samples.Write(buffer, buffer_size);
+      assert(written_size == buffer_size); //There is enough space since this thread is the only one which writes
+      Notify(samples_rendered);
+    }
+  }
+
+  template<typename T>
+  void AudioPlayer<T>::FeedSink()
+  {
+    comutils::TraceScope::SetThreadName("Audio playback");
+    const size_t period_bytes = period_size * frame_size;
+    std::vector<unsigned char> buffer(period_bytes);
+    bool started = false; //There cannot be any underruns before the first period has been played back
+    while (playing)
+    {
+      {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        if (started && !paused && rendered_samples.GetReadableCount() < period_bytes && sink.IsRealTime()) //Other sinks are expected to wait for samples
+          underrun_count++;
+        samples_rendered.wait(lock, [this, period_bytes]()
+                                                       {
+                                                         return !playing || (!paused && rendered_samples.GetReadableCount() >= period_bytes); //Also wait here while paused so that no CPU time is used
+                                                       });
+      }
+      if (!playing)
+        break;
+      rendered_samples.Read(buffer.data(), period_bytes);
+      Notify(samples_played); //Render the next period while this one is played back
+      const comutils::TraceScope trace_scope("Write");
+      sink.Write(buffer.data(), period_bytes);
+      started = true;
+    }
   }
 
   template<typename T>
@@ -93,30 +218,11 @@ namespace sndutils
   {
     if (playing)
       throw std::runtime_error("Already playing. Stop playback first.");
+    rendered_samples.Clear(); //Discard samples rendered for previous playback
+    underrun_count = 0;
     playing = true;
-    
-    const size_t this_number_of_channels = this->sample_format.channels;
-    const auto &this_playing = this->playing;
-    const auto &this_paused = this->paused;
-    ao_device * const &this_playback_device = this->playback_device;
-    worker = std::thread([&generator, this_number_of_channels, &this_playing, &this_paused, &this_playback_device]
-                         ()
-                         {
-                           WaveFormConverter<T> converter(generator, this_number_of_channels);
-                           while (this_playing)
-                           {
-                             if (this_paused) //Allow other threads to work while waiting for playback to resume
-                               std::this_thread::yield();
-                             else
-                             {
-                               unsigned char *buffer;
-                               size_t buffer_size = converter.GetNextSampleBuffer(buffer);
-                               static_assert(sizeof(char) == 1 && sizeof(char) == sizeof(unsigned char), "Both, char and unsigned char, must be one byte in size");
-                               if (!ao_play(this_playback_device, reinterpret_cast<char*>(buffer), buffer_size)) //TODO: Double-buffering to avoid pauses
-                                 throw std::runtime_error("Playback error. Don't use this instance again.");
-                             }
-                           }
-                         });
+    renderer = std::thread(&AudioPlayer<T>::RenderSamples, this, std::ref(generator));
+    feeder = std::thread(&AudioPlayer<T>::FeedSink, this);
   }
 
   template<typename T>
@@ -124,8 +230,14 @@ namespace sndutils
   {
     if (!playing)
       return;
-    playing = false;
-    worker.join();
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex); //Avoid missed wake-ups of threads which are about to wait
+      playing = false;
+    }
+    samples_rendered.notify_all();
+    samples_played.notify_all();
+    renderer.join();
+    feeder.join();
   }
 
   template<typename T>
@@ -141,7 +253,11 @@ namespace sndutils
   {
     if (!playing)
       throw std::runtime_error("Not playing. Start playback first.");
-    paused = false;
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex); //Avoid missed wake-ups of threads which are about to wait
+      paused = false;
+    }
+    samples_rendered.notify_all();
   }
 
   template<typename T>
@@ -156,11 +272,46 @@ namespace sndutils
     return playing && !paused;
   }
 
+  template<typename T>
+  size_t AudioPlayer<T>::GetUnderrunCount() const
+  {
+    return underrun_count;
+  }
+
+  template<typename T>
+  double AudioPlayer<T>::GetEstimatedLatency() const
+  {
+    const size_t queued_frames = rendered_samples.GetReadableCount() / frame_size + period_size; //Samples which have been rendered plus the period which is currently being played back. The device's internal buffers are unknown.
+    return static_cast<double>(queued_frames) / sink.GetFormat().sampling_rate;
+  }
+
+  template<typename T>
+  void AudioPlayer<T>::SetTap(comutils::RingBuffer<T> * const tap)
+  {
+    if (playing)
+      throw std::runtime_error("Already playing. Stop playback first.");
+    this->tap = tap;
+  }
+
   template<typename T>
   AudioPlayer<T>::~AudioPlayer()
   {
     Stop();
-    ao_close(playback_device);
-    ao_shutdown();
+  }
+
+  template<typename T>
+  void Render(comutils::WaveFormGenerator<T> &generator, AudioSink &sink, const size_t frame_count, const size_t period_size)
+  {
+    const auto &format = sink.GetFormat();
+    if (format.sample_size != WaveFormConverter<T>::sample_size)
+      throw std::runtime_error("The sink's sample size does not match the sample type");
+    WaveFormConverter<T> converter(generator, format.number_of_channels, period_size);
+    for (size_t rendered_frames = 0; rendered_frames < frame_count; rendered_frames += period_size)
+    {
+      unsigned char *buffer;
+      converter.GetNextSampleBuffer(buffer);
+      const size_t current_frames = std::min(period_size, frame_count - rendered_frames); //The last period may be incomplete
+      sink.Write(buffer, current_frames * format.GetFrameSize());
+    }
   }
 }
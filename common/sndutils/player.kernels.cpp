@@ -0,0 +1,43 @@
+//Audio playback helper class (kernels, compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "player.kernels.hpp"
+
+namespace sndutils
+{
+  //Copies each value to N consecutive (interleaved) channels
+  template<typename Lane, size_t N>
+  static void ReplicateChannels(const Lane * const values, Lane * const output, const size_t count)
+  {
+    size_t unit = 0;
+#if CV_SIMD
+    using Vector = decltype(cv::vx_load(values));
+    const size_t lanes = cv::VTraits<Vector>::vlanes();
+    for (; unit + lanes <= count; unit += lanes)
+    {
+      const Vector vector = cv::vx_load(values + unit);
+      if constexpr (N == 2)
+        cv::v_store_interleave(output + N * unit, vector, vector);
+      else if constexpr (N == 3)
+        cv::v_store_interleave(output + N * unit, vector, vector, vector);
+      else
+        cv::v_store_interleave(output + N * unit, vector, vector, vector, vector);
+    }
+    cv::vx_cleanup();
+#endif
+    for (; unit < count; unit++) //std::fill_n is not used since it is not specific to the dispatch target (see cpudispatch.hpp)
+    {
+      for (size_t channel = 0; channel < N; channel++)
+        output[N * unit + channel] = values[unit];
+    }
+  }
+
+  const SampleConversionKernels CPU_DISPATCH_NAME(sample_conversion_kernels) {{ReplicateChannels<unsigned char, 2>, ReplicateChannels<unsigned char, 3>, ReplicateChannels<unsigned char, 4>},
+                                                                              {ReplicateChannels<unsigned short, 2>, ReplicateChannels<unsigned short, 3>, ReplicateChannels<unsigned short, 4>},
+                                                                              {ReplicateChannels<unsigned int, 2>, ReplicateChannels<unsigned int, 3>, ReplicateChannels<unsigned int, 4>}};
+}
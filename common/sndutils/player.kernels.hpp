@@ -0,0 +1,25 @@
+//Audio playback helper class (kernels, header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+
+#include "cpudispatch.hpp"
+
+namespace sndutils
+{
+  //Row kernels for converting samples into interleaved playback buffers, compiled once per dispatch target (see cpudispatch.hpp). The signedness of the samples is irrelevant for copying, so only unsigned types are used.
+  struct SampleConversionKernels
+  {
+    //Copies each 8-bit sample to two, three or four consecutive (interleaved) channels (index: number of channels minus two)
+    void (*ReplicateChannels8[3])(const unsigned char * const values, unsigned char * const output, const size_t count);
+    //Copies each 16-bit sample to two, three or four consecutive (interleaved) channels (index: number of channels minus two)
+    void (*ReplicateChannels16[3])(const unsigned short * const values, unsigned short * const output, const size_t count);
+    //Copies each 32-bit sample to two, three or four consecutive (interleaved) channels (index: number of channels minus two)
+    void (*ReplicateChannels32[3])(const unsigned int * const values, unsigned int * const output, const size_t count);
+  };
+
+  CPU_DISPATCH_DECLARE(SampleConversionKernels, sample_conversion_kernels);
+}
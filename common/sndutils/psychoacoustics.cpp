@@ -0,0 +1,110 @@
+//Psychoacoustic masking model
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "math.hpp"
+#include "psychoacoustics.hpp"
+#include "psychoacoustics.kernels.hpp"
+
+namespace sndutils
+{
+  static constexpr double level_to_exponent = M_LN10 / 10; //Converts power levels in dB into natural exponents
+  static constexpr double exponent_to_level = 10 / M_LN10;
+  static constexpr double hann_noise_bandwidth = 1.5; //Equivalent noise bandwidth of the Hann window in bins. Spectra are scaled so that the peak bin of a tone has the tone's level, so the power of a tone is spread over this many bins on average.
+
+  //Returns the absolute threshold of hearing in dB SPL at the specified frequency in Hertz (approximation by Terhardt)
+  static double GetAbsoluteThresholdLevel(const double frequency)
+  {
+    const double frequency_kHz = std::max(frequency, 20.0) / 1000; //The approximation diverges towards 0 Hz, so use the threshold at the lower limit of hearing below it
+    return 3.64 * pow(frequency_kHz, -0.8) - 6.5 * exp(-0.6 * comutils::sqr(frequency_kHz - 3.3)) + 1e-3 * pow(frequency_kHz, 4);
+  }
+
+  //Returns the level in dB by which a masker is spread to a band which is the specified distance in Bark above it (spreading function by Schroeder et al.)
+  static double GetSpreadingLevel(const double bark_distance)
+  {
+    const double shifted_distance = bark_distance + 0.474;
+    return 15.81 + 7.5 * shifted_distance - 17.5 * sqrt(1 + comutils::sqr(shifted_distance));
+  }
+
+  //Returns the level in dB by which the threshold caused by a masker at the specified position in Bark is below the masker's level (offset for tonal maskers by Johnston)
+  static double GetMaskingOffset(const double bark)
+  {
+    return 14.5 + bark;
+  }
+
+  MaskingModel::MaskingModel(const unsigned int sampling_rate, const size_t bin_count, const double band_width)
+   : bin_bands(bin_count), absolute_threshold(1, bin_count),
+     bin_powers(1, bin_count), bin_thresholds(1, bin_count)
+  {
+    assert(sampling_rate > 0);
+    assert(bin_count > 1);
+    assert(band_width > 0);
+    for (size_t bin = 0; bin < bin_count; bin++)
+    {
+      const double frequency = 0.5 * sampling_rate * bin / (bin_count - 1);
+      bin_bands[bin] = static_cast<int>(GetBark(frequency) / band_width);
+      absolute_threshold(0, bin) = static_cast<float>(pow(10, (GetAbsoluteThresholdLevel(frequency) - full_scale_level) / 10));
+    }
+    const int band_count = bin_bands.back() + 1; //Bark values grow monotonically with the frequency
+    band_powers.create(1, band_count);
+    band_thresholds.create(1, band_count);
+    spreading.create(band_count, band_count);
+    for (int masked_band = 0; masked_band < band_count; masked_band++)
+    {
+      for (int masker_band = 0; masker_band < band_count; masker_band++)
+      {
+        const double masked_bark = (masked_band + 0.5) * band_width; //Band centers
+        const double masker_bark = (masker_band + 0.5) * band_width;
+        const double level = GetSpreadingLevel(masked_bark - masker_bark) - GetMaskingOffset(masker_bark);
+        spreading(masked_band, masker_band) = static_cast<float>(pow(10, level / 10));
+      }
+    }
+  }
+
+  size_t MaskingModel::GetBinCount() const
+  {
+    return bin_bands.size();
+  }
+
+  size_t MaskingModel::GetBandCount() const
+  {
+    return band_powers.cols;
+  }
+
+  static const MaskingKernels &GetKernels()
+  {
+    static const MaskingKernels &kernels = CPU_DISPATCH_SELECT(masking_kernels);
+    return kernels;
+  }
+
+  void MaskingModel::GetMaskingThreshold(const std::vector<double> &levels, std::vector<double> &threshold)
+  {
+    assert(levels.size() == GetBinCount());
+    const int bin_count = static_cast<int>(GetBinCount());
+    for (int bin = 0; bin < bin_count; bin++)
+      bin_powers(0, bin) = static_cast<float>(level_to_exponent * levels[bin]);
+    cv::exp(bin_powers, bin_powers); //Vectorized internally
+    band_powers = 0.f;
+    for (int bin = 0; bin < bin_count; bin++)
+      band_powers(0, bin_bands[bin]) += bin_powers(0, bin);
+    band_powers *= 1 / hann_noise_bandwidth; //Correct the sum of the bins of a tone so that the band power equals the tone's power (instead of overstating it by about 1.76 dB)
+    const auto &kernels = GetKernels();
+    for (int band = 0; band < band_powers.cols; band++) //Spread the power of all maskers to each band at once so that the effort does not depend on the number of maskers
+      band_thresholds(0, band) = kernels.GetDotProduct(spreading[band], band_powers[0], band_powers.cols);
+    for (int bin = 0; bin < bin_count; bin++)
+      bin_thresholds(0, bin) = band_thresholds(0, bin_bands[bin]) + absolute_threshold(0, bin);
+    cv::log(bin_thresholds, bin_thresholds);
+    threshold.resize(bin_count);
+    for (int bin = 0; bin < bin_count; bin++)
+      threshold[bin] = exponent_to_level * bin_thresholds(0, bin);
+  }
+
+  double MaskingModel::GetBark(const double frequency)
+  {
+    return 13 * atan(0.00076 * frequency) + 3.5 * atan(comutils::sqr(frequency / 7500)); //Approximation by Zwicker and Terhardt
+  }
+}
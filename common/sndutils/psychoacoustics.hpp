@@ -0,0 +1,43 @@
+//Psychoacoustic masking model (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace sndutils
+{
+  //Calculates the global masking threshold of a spectrum, i.e., the level below which components are inaudible in the presence of all other components. The power of the spectrum is accumulated in bands of equal width on the Bark scale (filterbank) and spread to all other bands with a precomputed spreading matrix. The absolute threshold of hearing is added to the result.
+  class MaskingModel
+  {
+    public:
+      //Prepares the model for spectra with bin_count bins which are equally spaced between 0 Hz and half of the specified sampling rate. The width of the bands is specified in Bark.
+      MaskingModel(const unsigned int sampling_rate, const size_t bin_count, const double band_width = 0.5);
+
+      //Returns the number of bins of the spectra which the model expects
+      size_t GetBinCount() const;
+      //Returns the number of bands of the filterbank
+      size_t GetBandCount() const;
+      //Calculates the global masking threshold in dB for each bin from the specified levels in dB of each bin. Levels are relative to the level of a sinusodial tone with the maximum amplitude (see full_scale_level).
+      void GetMaskingThreshold(const std::vector<double> &levels, std::vector<double> &threshold);
+
+      //Converts a frequency in Hertz into Bark
+      static double GetBark(const double frequency);
+
+      //Assumed sound pressure level in dB of a sinusodial tone with the maximum amplitude when played back. This relates the absolute threshold of hearing to the levels of the spectrum.
+      static constexpr double full_scale_level = 96;
+
+    private:
+      std::vector<int> bin_bands; //Index of the band each bin belongs to
+      cv::Mat_<float> absolute_threshold; //Power of the absolute threshold of hearing for each bin
+      cv::Mat_<float> spreading; //Power which a masker in each band (column) contributes to the threshold of each band (row)
+      cv::Mat_<float> bin_powers;
+      cv::Mat_<float> band_powers;
+      cv::Mat_<float> band_thresholds;
+      cv::Mat_<float> bin_thresholds;
+  };
+}
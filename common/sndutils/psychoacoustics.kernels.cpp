@@ -0,0 +1,31 @@
+//Psychoacoustic masking model (kernels, compiled once per dispatch target)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include "cpudispatch.hpp" //Needs to be included before OpenCV's headers
+
+#include <opencv2/core/hal/intrin.hpp>
+
+#include "psychoacoustics.kernels.hpp"
+
+namespace sndutils
+{
+  static float GetDotProduct(const float * const values1, const float * const values2, const int count)
+  {
+    int i = 0;
+    float sum = 0;
+#if CV_SIMD
+    const int lanes = cv::VTraits<cv::v_float32>::vlanes();
+    cv::v_float32 sums = cv::vx_setzero_f32();
+    for (; i <= count - lanes; i += lanes)
+      sums = cv::v_fma(cv::vx_load(values1 + i), cv::vx_load(values2 + i), sums);
+    sum = cv::v_reduce_sum(sums);
+    cv::vx_cleanup();
+#endif
+    for (; i < count; i++)
+      sum += values1[i] * values2[i];
+    return sum;
+  }
+
+  const MaskingKernels CPU_DISPATCH_NAME(masking_kernels) {GetDotProduct};
+}
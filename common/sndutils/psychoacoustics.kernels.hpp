@@ -0,0 +1,19 @@
+//Psychoacoustic masking model (kernels, header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include "cpudispatch.hpp"
+
+namespace sndutils
+{
+  //Row kernels for the masking model, compiled once per dispatch target (see cpudispatch.hpp)
+  struct MaskingKernels
+  {
+    //Returns the sum of the element-wise products of the first count values of both arrays
+    float (*GetDotProduct)(const float * const values1, const float * const values2, const int count);
+  };
+
+  CPU_DISPATCH_DECLARE(MaskingKernels, masking_kernels);
+}
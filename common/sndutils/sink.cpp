@@ -0,0 +1,154 @@
+//Audio sinks for playback, files and benchmarking
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <stdexcept>
+#include <limits>
+
+#include "sink.hpp"
+
+namespace sndutils
+{
+  size_t SampleFormat::GetFrameSize() const
+  {
+    return number_of_channels * sample_size;
+  }
+
+  AudioSink::AudioSink(const SampleFormat &format)
+   : format(format)
+  {
+    assert(format.sampling_rate > 0);
+    assert(format.number_of_channels > 0);
+    assert(format.sample_size > 0);
+  }
+
+  const SampleFormat &AudioSink::GetFormat() const
+  {
+    return format;
+  }
+
+  LiveAudioSink::LiveAudioSink(const SampleFormat &format)
+   : AudioSink(format)
+  {
+    ao_sample_format sample_format;
+    sample_format.bits = static_cast<int>(8 * format.sample_size);
+    sample_format.channels = static_cast<int>(format.number_of_channels);
+    sample_format.rate = static_cast<int>(format.sampling_rate);
+    sample_format.byte_format = AO_FMT_LITTLE; //Use little endian
+    sample_format.matrix = nullptr;
+
+    ao_initialize();
+    const int driver_id = ao_default_driver_id();
+    if (!(playback_device = ao_open_live(driver_id, &sample_format, nullptr)))
+    {
+      ao_shutdown();
+      throw std::runtime_error("Could not open playback device");
+    }
+  }
+
+  LiveAudioSink::~LiveAudioSink()
+  {
+    ao_close(playback_device);
+    ao_shutdown();
+  }
+
+  bool LiveAudioSink::IsRealTime() const
+  {
+    return true;
+  }
+
+  void LiveAudioSink::Write(const unsigned char * const samples, const size_t size)
+  {
+    assert(size % format.GetFrameSize() == 0);
+    static_assert(sizeof(char) == 1 && sizeof(char) == sizeof(unsigned char), "Both, char and unsigned char, must be one byte in size");
+    if (!ao_play(playback_device, const_cast<char*>(reinterpret_cast<const char*>(samples)), size)) //libao does not modify the samples
+      throw std::runtime_error("Playback error. Don't use this instance again.");
+  }
+
+  //Writes the value in little-endian byte order
+  template<typename T>
+  static void WriteLittleEndian(std::ostream &stream, const T value)
+  {
+    for (size_t byte = 0; byte < sizeof(T); byte++)
+      stream.put(static_cast<char>((value >> (8 * byte)) & 0xFF));
+  }
+
+  WaveFileSink::WaveFileSink(const std::string &filename, const SampleFormat &format)
+   : AudioSink(format), file(filename, std::ios::binary), data_size(0)
+  {
+    if (!file)
+      throw std::runtime_error("Could not create WAV file '" + filename + "'");
+    WriteHeader(); //Preliminary header which is completed on destruction
+  }
+
+  WaveFileSink::~WaveFileSink()
+  {
+    file.seekp(0);
+    WriteHeader();
+  }
+
+  void WaveFileSink::WriteHeader()
+  {
+    constexpr uint32_t format_chunk_size = 16;
+    constexpr uint16_t PCM_format = 1;
+    const uint32_t frame_size = static_cast<uint32_t>(format.GetFrameSize());
+    file.write("RIFF", 4);
+    WriteLittleEndian<uint32_t>(file, 4 + (8 + format_chunk_size) + (8 + data_size)); //Size of the WAVE identifier plus the format and data chunks
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    WriteLittleEndian<uint32_t>(file, format_chunk_size);
+    WriteLittleEndian<uint16_t>(file, PCM_format);
+    WriteLittleEndian<uint16_t>(file, static_cast<uint16_t>(format.number_of_channels));
+    WriteLittleEndian<uint32_t>(file, format.sampling_rate);
+    WriteLittleEndian<uint32_t>(file, format.sampling_rate * frame_size); //Bytes per second
+    WriteLittleEndian<uint16_t>(file, static_cast<uint16_t>(frame_size));
+    WriteLittleEndian<uint16_t>(file, static_cast<uint16_t>(8 * format.sample_size));
+    file.write("data", 4);
+    WriteLittleEndian<uint32_t>(file, data_size);
+  }
+
+  bool WaveFileSink::IsRealTime() const
+  {
+    return false;
+  }
+
+  void WaveFileSink::Write(const unsigned char * const samples, const size_t size)
+  {
+    assert(size % format.GetFrameSize() == 0);
+    constexpr size_t header_size = 44;
+    if (size > std::numeric_limits<uint32_t>::max() - header_size - data_size)
+      throw std::runtime_error("WAV files cannot be larger than 4 GiB");
+    if (format.sample_size == 1) //8-bit WAV samples are unsigned
+    {
+      converted_samples.resize(size);
+      for (size_t i = 0; i < size; i++)
+        converted_samples[i] = samples[i] ^ 0x80; //Offset by 128
+      file.write(reinterpret_cast<const char*>(converted_samples.data()), size);
+    }
+    else
+      file.write(reinterpret_cast<const char*>(samples), size);
+    if (!file)
+      throw std::runtime_error("Could not write to WAV file");
+    data_size += static_cast<uint32_t>(size);
+  }
+
+  NullAudioSink::NullAudioSink(const SampleFormat &format)
+   : AudioSink(format), frame_count(0) { }
+
+  bool NullAudioSink::IsRealTime() const
+  {
+    return false;
+  }
+
+  void NullAudioSink::Write(const unsigned char * const, const size_t size)
+  {
+    assert(size % format.GetFrameSize() == 0);
+    frame_count += size / format.GetFrameSize();
+  }
+
+  size_t NullAudioSink::GetFrameCount() const
+  {
+    return frame_count;
+  }
+}
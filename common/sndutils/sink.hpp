@@ -0,0 +1,105 @@
+//Audio sinks for playback, files and benchmarking (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ao/ao.h>
+
+namespace sndutils
+{
+  //Format of interleaved audio samples in little-endian byte order
+  struct SampleFormat
+  {
+    unsigned int sampling_rate;
+    size_t number_of_channels;
+    size_t sample_size; //In bytes
+
+    //Returns the size of one sample for each channel in bytes
+    size_t GetFrameSize() const;
+  };
+
+  //Defines an abstract destination for audio samples
+  class AudioSink
+  {
+    public:
+      //Constructs a new instance of AudioSink which accepts samples of the given format
+      AudioSink(const SampleFormat &format);
+      AudioSink(const AudioSink &original) = delete; //Explicitly delete the copy constructor since sinks own devices or files
+      virtual ~AudioSink() = default;
+
+      //Returns the format of the samples which the sink accepts
+      const SampleFormat &GetFormat() const;
+      //Returns whether writing takes as long as playing back the samples. To be implemented in child classes.
+      virtual bool IsRealTime() const = 0;
+      //Writes the specified number of bytes of samples (complete frames only). To be implemented in child classes.
+      virtual void Write(const unsigned char * const samples, const size_t size) = 0;
+
+    protected:
+      const SampleFormat format;
+  };
+
+  //Plays back samples on the default playback device
+  class LiveAudioSink : public AudioSink
+  {
+    public:
+      //Opens the default playback device with the given format. Make sure that the device is configured accordingly.
+      LiveAudioSink(const SampleFormat &format);
+      ~LiveAudioSink();
+
+      //Returns true since writing blocks until the device can accept more samples
+      bool IsRealTime() const override;
+      //Passes the samples to the playback device
+      void Write(const unsigned char * const samples, const size_t size) override;
+
+    private:
+      ao_device *playback_device;
+  };
+
+  //Writes samples into a WAV file as they arrive. 8-bit samples are expected to be signed and are converted to unsigned samples as required by the WAV format.
+  class WaveFileSink : public AudioSink
+  {
+    public:
+      //Creates (or overwrites) the WAV file with the specified name for samples of the given format
+      WaveFileSink(const std::string &filename, const SampleFormat &format);
+      //Completes the file's header with the number of written samples and closes the file
+      ~WaveFileSink();
+
+      //Returns false since samples are written as fast as possible
+      bool IsRealTime() const override;
+      //Appends the samples to the file
+      void Write(const unsigned char * const samples, const size_t size) override;
+
+    private:
+      std::ofstream file;
+      uint32_t data_size; //In bytes
+      std::vector<unsigned char> converted_samples; //For 8-bit samples (reused for all writes)
+
+      void WriteHeader();
+  };
+
+  //Discards all samples and only counts them, e.g., for benchmarking
+  class NullAudioSink : public AudioSink
+  {
+    public:
+      //Constructs a new instance of NullAudioSink which accepts samples of the given format
+      NullAudioSink(const SampleFormat &format);
+
+      //Returns false since samples are discarded immediately
+      bool IsRealTime() const override;
+      //Counts the samples
+      void Write(const unsigned char * const samples, const size_t size) override;
+
+      //Returns the number of samples per channel written so far
+      size_t GetFrameCount() const;
+
+    private:
+      size_t frame_count;
+  };
+}
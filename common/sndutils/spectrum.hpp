@@ -0,0 +1,67 @@
+//Streaming spectrum analyzer (header)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#pragma once
+
+#include <cstddef>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "ringbuf.hpp"
+
+namespace sndutils
+{
+  //Analyzes the spectrum of a stream of audio samples of base type T in overlapping, windowed frames (short-time Fourier transform) on a background thread. Samples are passed to the analyzer through a lock-free tap so that the producer, e.g., an audio player, never has to wait for the analysis.
+  template<typename T>
+  class SpectrumAnalyzer
+  {
+    public:
+      //Starts analyzing samples with the given sampling rate in frames of frame_size samples (must be a power of two) which are hop_size samples apart. The levels of the last history_size frames are kept.
+      SpectrumAnalyzer(const unsigned int sampling_rate = 48000, const size_t frame_size = 8192, const size_t hop_size = 2048, const size_t history_size = 256);
+      SpectrumAnalyzer(const SpectrumAnalyzer &original) = delete; //Explicitly delete the copy constructor since the tap is shared with the producer
+      //Stops the analysis
+      ~SpectrumAnalyzer();
+
+      //Returns the tap which samples (of one channel) are to be written into. Samples which do not fit into the tap are expected to be dropped by the producer.
+      comutils::RingBuffer<T> &GetTap();
+
+      //Returns the number of frequency bins of each analyzed frame
+      size_t GetBinCount() const;
+      //Returns the frequency in Hertz which the specified bin corresponds to
+      double GetBinFrequency(const size_t bin) const;
+      //Returns the levels in dB of all bins of the most recently analyzed frame. A sinusodial tone with the maximum amplitude of T has a level of 0 dB. If no frame has been analyzed yet, all levels are at the minimum level.
+      std::vector<double> GetSpectrum() const;
+      //Returns the levels in dB of the most recently analyzed frames with one row per frame (oldest first) and one column per bin. Rows of frames which have not been analyzed yet are at the minimum level.
+      cv::Mat_<float> GetSpectrogram() const;
+
+      //Lowest level in dB which is reported. Lower levels, e.g., of silence, are clipped.
+      static constexpr double min_level = -120;
+
+    private:
+      const unsigned int sampling_rate;
+      const size_t frame_size;
+      const size_t hop_size;
+      comutils::RingBuffer<T> tap;
+      cv::Mat_<float> window; //Hann window
+      cv::Mat_<float> frame; //Samples of the current frame (oldest first)
+      cv::Mat_<float> windowed_frame;
+      cv::Mat_<cv::Vec2f> coefficients;
+      cv::Mat_<float> levels; //One row per frame in the order of analysis (ring buffer)
+      size_t last_row; //Row of the most recently analyzed frame
+      mutable std::mutex levels_mutex;
+      std::mutex wait_mutex; //Only used for waiting for samples
+      std::condition_variable stop_requested;
+      bool stopping;
+      std::thread analyzer;
+
+      void Analyze();
+      void AnalyzeFrame();
+  };
+}
+
+#include "spectrum.impl.hpp"
@@ -0,0 +1,130 @@
+//Streaming spectrum analyzer (template implementation)
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "math.hpp"
+#include "trace.hpp"
+
+//#include "spectrum.hpp"
+
+namespace sndutils
+{
+  template<typename T>
+  SpectrumAnalyzer<T>::SpectrumAnalyzer(const unsigned int sampling_rate, const size_t frame_size, const size_t hop_size, const size_t history_size)
+   : sampling_rate(sampling_rate), frame_size(frame_size), hop_size(hop_size),
+     tap(4 * frame_size), //Enough to compensate for delayed analysis without dropping samples
+     window(1, frame_size), frame(1, frame_size, 0.f), windowed_frame(1, frame_size),
+     levels(history_size, frame_size / 2 + 1, static_cast<float>(min_level)), last_row(history_size - 1),
+     stopping(false)
+  {
+    assert(sampling_rate > 0);
+    assert(frame_size > 1 && (frame_size & (frame_size - 1)) == 0);
+    assert(hop_size > 0 && hop_size <= frame_size);
+    assert(history_size > 0);
+    for (size_t i = 0; i < frame_size; i++)
+      window(0, i) = 0.5 - 0.5 * cos(2 * M_PI * i / frame_size); //Periodic Hann window
+    analyzer = std::thread(&SpectrumAnalyzer<T>::Analyze, this);
+  }
+
+  template<typename T>
+  SpectrumAnalyzer<T>::~SpectrumAnalyzer()
+  {
+    {
+      std::lock_guard<std::mutex> lock(wait_mutex);
+      stopping = true;
+    }
+    stop_requested.notify_one();
+    analyzer.join();
+  }
+
+  template<typename T>
+  comutils::RingBuffer<T> &SpectrumAnalyzer<T>::GetTap()
+  {
+    return tap;
+  }
+
+  template<typename T>
+  size_t SpectrumAnalyzer<T>::GetBinCount() const
+  {
+    return levels.cols;
+  }
+
+  template<typename T>
+  double SpectrumAnalyzer<T>::GetBinFrequency(const size_t bin) const
+  {
+    return static_cast<double>(bin) * sampling_rate / frame_size;
+  }
+
+  template<typename T>
+  std::vector<double> SpectrumAnalyzer<T>::GetSpectrum() const
+  {
+    std::lock_guard<std::mutex> lock(levels_mutex);
+    const float * const row = levels[last_row];
+    return std::vector<double>(row, row + levels.cols);
+  }
+
+  template<typename T>
+  cv::Mat_<float> SpectrumAnalyzer<T>::GetSpectrogram() const
+  {
+    std::lock_guard<std::mutex> lock(levels_mutex);
+    cv::Mat_<float> spectrogram(levels.size());
+    const int first_row = (last_row + 1) % levels.rows; //Oldest frame
+    levels.rowRange(first_row, levels.rows).copyTo(spectrogram.rowRange(0, levels.rows - first_row));
+    levels.rowRange(0, first_row).copyTo(spectrogram.rowRange(levels.rows - first_row, levels.rows));
+    return spectrogram;
+  }
+
+  template<typename T>
+  void SpectrumAnalyzer<T>::Analyze()
+  {
+    comutils::TraceScope::SetThreadName("Spectrum analysis");
+    const auto hop_duration = std::chrono::duration<double>(static_cast<double>(hop_size) / sampling_rate);
+    const auto poll_interval = std::chrono::duration_cast<std::chrono::milliseconds>(hop_duration / 2); //Check for new samples twice per hop so that frames are analyzed soon after their samples arrive
+    std::vector<T> new_samples(hop_size);
+    size_t new_sample_count = 0;
+    while (true)
+    {
+      new_sample_count += tap.Read(new_samples.data() + new_sample_count, hop_size - new_sample_count);
+      if (new_sample_count < hop_size)
+      {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        if (stop_requested.wait_for(lock, poll_interval, [this]()
+                                                                  {
+                                                                    return stopping;
+                                                                  }))
+          break;
+        continue;
+      }
+      std::copy(frame.begin() + hop_size, frame.end(), frame.begin()); //Drop the oldest samples
+      std::copy(new_samples.begin(), new_samples.end(), frame.end() - hop_size);
+      new_sample_count = 0;
+      const comutils::TraceScope trace_scope("AnalyzeFrame");
+      AnalyzeFrame();
+    }
+  }
+
+  template<typename T>
+  void SpectrumAnalyzer<T>::AnalyzeFrame()
+  {
+    cv::multiply(frame, window, windowed_frame);
+    cv::dft(windowed_frame, coefficients, cv::DFT_COMPLEX_OUTPUT);
+    constexpr double window_gain = 0.5; //Mean of the Hann window
+    const double reference_magnitude = window_gain * frame_size * std::numeric_limits<T>::max() / 2; //Magnitude of a sinusodial tone with the maximum amplitude (split between positive and negative frequencies)
+    std::lock_guard<std::mutex> lock(levels_mutex);
+    last_row = (last_row + 1) % levels.rows;
+    float * const row = levels[last_row];
+    for (int bin = 0; bin < levels.cols; bin++)
+    {
+      const cv::Vec2f &coefficient = coefficients(0, bin);
+      const double magnitude = hypot(coefficient[0], coefficient[1]);
+      const double level = comutils::GetLevelFromValue(magnitude, reference_magnitude);
+      row[bin] = static_cast<float>(std::max(level, min_level));
+    }
+  }
+}
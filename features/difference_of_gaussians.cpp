@@ -1,5 +1,5 @@
 //Illustration of DoG computation
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -7,8 +7,10 @@
 #include <opencv2/core.hpp>
 #include <opencv2/imgproc.hpp>
 
+#include "canvas.hpp"
 #include "combine.hpp"
 #include "format.hpp"
+#include "trace.hpp"
 #include "imgmath.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
@@ -27,28 +29,32 @@ class DoG_data
     imgutils::MultiWindow all_windows;
     
     const cv::Mat image;
+    cv::Mat converted_difference_image; //Reused between updates
+    imgutils::Canvas canvas; //Both blurred images next to each other
 
     void UpdateDifferenceImage(const cv::Mat &first_image, const cv::Mat &second_image)
     {
       assert(first_image.type() == CV_8UC1);
       assert(first_image.type() == CV_8UC1);
       const cv::Mat difference_image = imgutils::SubtractImages(first_image, second_image);
-      const cv::Mat converted_difference_image = imgutils::ConvertDifferenceImage(difference_image);
+      imgutils::ConvertDifferenceImage(difference_image, converted_difference_image);
       difference_window.UpdateContent(converted_difference_image);
     }
     
     static void UpdateImages(DoG_data &data)
     {
+      const comutils::TraceScope trace_scope("UpdateImages");
       const cv::Mat &image = data.image;
       const int sigma_percent = data.sigma_trackbar.GetValue();
       const int k_percent = data.k_trackbar.GetValue();
       const double sigma = sigma_percent / 100.0;
       const double k = k_percent / 100.0;
-      cv::Mat blurred_image_sigma, blurred_image_k_times_sigma;
-      GaussianBlur(image, blurred_image_sigma, cv::Size(), sigma);
+      auto &canvas = data.canvas;
+      cv::Mat blurred_image_sigma = canvas.GetTile(0);
+      cv::Mat blurred_image_k_times_sigma = canvas.GetTile(1);
+      GaussianBlur(image, blurred_image_sigma, cv::Size(), sigma); //Blur directly into the canvas
       GaussianBlur(image, blurred_image_k_times_sigma, cv::Size(), k * sigma);
-      const cv::Mat combined_image = imgutils::CombineImages({blurred_image_sigma, blurred_image_k_times_sigma}, imgutils::CombinationMode::Horizontal);
-      data.image_window.UpdateContent(combined_image);
+      data.image_window.UpdateContent(canvas.GetImage());
       data.UpdateDifferenceImage(blurred_image_k_times_sigma, blurred_image_sigma);
     }
 
@@ -76,7 +82,8 @@ class DoG_data
        k_trackbar(k_trackbar_name, image_window, static_cast<int>(max_k * 100), static_cast<int>(min_k * 100), static_cast<int>(default_k * 100), UpdateImages, *this), //k = 1.5 (150%) by default
        difference_window(difference_window_name),
        all_windows({&image_window, &difference_window}, imgutils::WindowAlignment::Horizontal),
-       image(image)
+       image(image),
+       canvas(image.size(), 2, imgutils::CombinationMode::Horizontal, 3, CV_8UC1)
     {
       UpdateImages(*this); //Update with default values
     }
@@ -1,5 +1,5 @@
 //Illustration of chrominance subsampling
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -7,40 +7,31 @@
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
-#include <opencv2/imgproc.hpp>
 
-#include "combine.hpp"
+#include "canvas.hpp"
 #include "format.hpp"
+#include "imgmath.hpp"
 #include "window.hpp"
+#include "yuvimage.hpp"
 
 struct color_format
 {
   const char * const name; //TODO: Make std::string, also in constructor (requires C++20)
-  const int conversion_id;
-  const int back_conversion_id;
+  const imgutils::ChromaFormat format;
   
-  cv::Mat ConvertImage(const cv::Mat &image, unsigned int &converted_size) const
-  {
-    cv::Mat converted_image;
-    assert(!image.empty());
-    cv::cvtColor(image, converted_image, conversion_id); //Convert to subsampled colorspace
-    converted_size = converted_image.total() * converted_image.elemSize();
-    cv::cvtColor(converted_image, converted_image, back_conversion_id); //Convert back
-    return converted_image;
-  }
-  
-  constexpr color_format(const char * const name, const int conversion_id, const int back_conversion_id) 
-   : name(name), conversion_id(conversion_id), back_conversion_id(back_conversion_id) { }
+  constexpr color_format(const char * const name, const imgutils::ChromaFormat format) 
+   : name(name), format(format) { }
 };
 
 class subsampling_data
 {
   protected: 
-    static constexpr const color_format color_formats[] {color_format("4:4:4", cv::COLOR_BGR2YUV, cv::COLOR_YUV2BGR),
-                                                         color_format("4:2:0", cv::COLOR_BGR2YUV_I420, cv::COLOR_YUV2BGR_I420),
-                                                         /*color_format("4:2:2", cv::COLOR_BGR2YUV_Y422, cv::COLOR_YUV2BGR_Y422)*/ //TODO: Find a conversion ID for BGR to YCbCr 4:2:2 and change order
-                                                         color_format("4:0:0", cv::COLOR_BGR2GRAY, cv::COLOR_GRAY2BGR)};
-    static constexpr auto &default_color_format = color_formats[1]; //4:2:0 by default
+    static constexpr const color_format color_formats[] {color_format("4:4:4", imgutils::ChromaFormat::Format444),
+                                                         color_format("4:2:2", imgutils::ChromaFormat::Format422),
+                                                         color_format("4:1:1", imgutils::ChromaFormat::Format411),
+                                                         color_format("4:2:0", imgutils::ChromaFormat::Format420),
+                                                         color_format("4:0:0", imgutils::ChromaFormat::Format400)};
+    static constexpr auto &default_color_format = color_formats[3]; //4:2:0 by default
     
     imgutils::Window window;
     
@@ -48,19 +39,29 @@ class subsampling_data
     std::unique_ptr<RadioButtonType> format_radiobuttons[comutils::arraysize(color_formats)];
     
     const cv::Mat image;
+    imgutils::YUVImage yuv_image; //Planar (subsampled) representation of the image, reused between updates
+    imgutils::Canvas canvas; //Original (left) and converted image (right)
     
     static void UpdateImage(subsampling_data &data, const color_format &format)
     {
       const auto &image = data.image;
-      const auto uncompressed_size = image.total() * image.elemSize();
-      unsigned int converted_size;
-      const cv::Mat converted_image = format.ConvertImage(image, converted_size);
-      const cv::Mat combined_image = imgutils::CombineImages({image, converted_image}, imgutils::CombinationMode::Horizontal);
+      const auto uncompressed_size = imgutils::GetPlanarImageSize(image.size(), imgutils::ChromaFormat::Format444);
+      auto &yuv_image = data.yuv_image;
+      auto &canvas = data.canvas;
+      cv::Mat converted_image = canvas.GetTile(1);
+      yuv_image.ConvertFrom(image, format.format); //Convert to subsampled colorspace
+      yuv_image.ConvertTo(converted_image); //Convert back directly into the canvas
+      const auto converted_size = yuv_image.GetByteSize();
       auto &window = data.window;
-      window.UpdateContent(combined_image);
+      window.UpdateContent(canvas.GetImage());
       if (window.IsShown())
       {
-        const std::string status_text = "4:4:4 (" + comutils::FormatByte(uncompressed_size) + ") vs. " + format.name + " (" + comutils::FormatByte(converted_size) + ")";
+        std::string status_text = "4:4:4 (" + comutils::FormatByte(uncompressed_size) + ") vs. " + format.name + " (" + comutils::FormatByte(converted_size) + ")";
+        if (imgutils::IsSSIMSupported(image.size())) //Very small images have no SSIM
+        {
+          const double SSIM = imgutils::SSIM(image, converted_image); //Mean across the B, G and R channels
+          status_text += ", SSIM: " + comutils::FormatValue(SSIM, 4);
+        }
         window.ShowOverlayText(status_text);
       }
     }
@@ -80,8 +81,10 @@ class subsampling_data
   public:    
     subsampling_data(const cv::Mat &image)
      : window(window_name),
-       image(image)
+       image(image),
+       canvas(image.size(), 2, imgutils::CombinationMode::Horizontal)
     {
+      canvas.UpdateTile(0, image); //The original image does not change
       AddRadioButtons();
       UpdateImage(*this, default_color_format); //Update with default values
     }
@@ -1,9 +1,13 @@
 //Illustration of the contrast sensitivity function
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <cmath>
+#include <chrono>
+#include <vector>
 
 #include <opencv2/core.hpp>
 
@@ -17,47 +21,168 @@ static double ExponentialProgression(const double minimum, const double maximum,
   return minimum * pow(maximum / minimum, static_cast<double>(step) / steps);
 }
 
-static cv::Mat GenerateCSFImage()
+class CSF_data
 {
-  constexpr int width = 800;
-  constexpr int height = 600;
-  constexpr double max_brightness = 255;
-  static_assert(max_brightness >= 0 && max_brightness <= 255, "Maximum brightness must fit into 8 bits (unsigned char)");
-  cv::Mat_<unsigned char> image(height, width, static_cast<unsigned char>(max_brightness));
-  image.forEach([](unsigned char &value, const int position[])
-                  {
-                    constexpr double min_frequency = 1;
-                    constexpr double max_frequency = width / 10; //TODO: width / 2 - 1 would be the Shannon limit; is there a sanity check for aliasing when frequency increases within one period? If width is too small, even the current value of 100 is too large
-                    constexpr double min_amplitude = 0.5; //Resolution limit (after rounding)
-                    constexpr double max_amplitude = static_cast<double>(max_brightness) / 2;
-                    static_assert(min_amplitude < max_amplitude, "Minimum amplitude must be smaller than maximum amplitude");
-                    constexpr double offset = max_brightness - max_amplitude;
-                    const int y = position[0];
-                    const int x = position[1];
-                    const double amplitude = ExponentialProgression(min_amplitude, max_amplitude, height, y + 1);
-                    const double phase = static_cast<double>(x) / width;
-                    const double frequency = ExponentialProgression(min_frequency, max_frequency, width, x + 1);
-                    value = offset + amplitude * sin(2 * M_PI * phase * frequency);
-                  });
-  return image;
-}
+  protected:
+    static constexpr double max_brightness = 255;
+    static_assert(max_brightness >= 0 && max_brightness <= 255, "Maximum brightness must fit into 8 bits (unsigned char)");
+    static constexpr double min_amplitude = 0.5; //Resolution limit (after rounding)
+    static constexpr double max_amplitude = max_brightness / 2;
+    static_assert(min_amplitude < max_amplitude, "Minimum amplitude must be smaller than maximum amplitude");
+    static constexpr double offset = max_brightness - max_amplitude;
+    static constexpr double drift_frequency = 0.5; //Phase drift in periods per second when animated
+    static constexpr int frame_delay = 1000 / 60; //Delay between frames in ms (approximately 60 frames per second)
+
+    imgutils::Window window;
+
+    using CheckBoxType = imgutils::CheckBox<CSF_data&>;
+    CheckBoxType animate_checkbox;
+
+    std::vector<float> amplitudes; //Amplitude of each row
+    std::vector<float> phase_sines; //Sine of the phase of each column (without drift)
+    std::vector<float> phase_cosines; //Cosine of the phase of each column (without drift)
+    std::vector<float> column_values; //Sine of the phase of each column (with drift)
+    cv::Mat_<unsigned char> image;
+
+    bool animating;
+    std::chrono::steady_clock::time_point animation_start_time;
+
+    static constexpr double min_frequency = 1;
+
+    static double GetMaxFrequency(const int width)
+    {
+      return width / 10.0; //TODO: width / 2 - 1 would be the Shannon limit; is there a sanity check for aliasing when frequency increases within one period? If width is too small, even the current value of width / 10 is too large
+    }
+
+    void InitializeTables(const int width, const int height)
+    {
+      const double max_frequency = GetMaxFrequency(width);
+      for (int y = 0; y < height; y++)
+        amplitudes[y] = ExponentialProgression(min_amplitude, max_amplitude, height, y + 1);
+      for (int x = 0; x < width; x++)
+      {
+        const double phase = static_cast<double>(x) / width;
+        const double frequency = ExponentialProgression(min_frequency, max_frequency, width, x + 1);
+        const double angle = 2 * M_PI * phase * frequency;
+        phase_sines[x] = sin(angle);
+        phase_cosines[x] = cos(angle);
+      }
+    }
+
+    void GenerateImage(const double phase_drift)
+    {
+      const float drift_sine = sin(phase_drift);
+      const float drift_cosine = cos(phase_drift);
+      for (int x = 0; x < image.cols; x++)
+        column_values[x] = phase_sines[x] * drift_cosine + phase_cosines[x] * drift_sine; //sin(a + b) = sin(a) * cos(b) + cos(a) * sin(b)
+      for (int y = 0; y < image.rows; y++) //The pattern is separable, i.e., each pixel is the product of its row's amplitude and its column's value
+      {
+        const float amplitude = amplitudes[y];
+        unsigned char * const row = image[y];
+        for (int x = 0; x < image.cols; x++)
+          row[x] = static_cast<unsigned char>(offset + amplitude * column_values[x]);
+      }
+    }
 
-static void ShowContrastSensitivityFunction()
+    void UpdateImage(const double phase_drift = 0)
+    {
+      GenerateImage(phase_drift);
+      window.UpdateContent(image);
+    }
+
+    void UpdateAnimation()
+    {
+      const std::chrono::duration<double> elapsed_time = std::chrono::steady_clock::now() - animation_start_time;
+      const double phase_drift = 2 * M_PI * drift_frequency * elapsed_time.count(); //Drift depends on the time rather than the number of frames so that it is independent of the actual frame rate
+      UpdateImage(phase_drift);
+    }
+
+    static void Animate(CSF_data &data) //The frames are updated in ShowImage so that key presses are still processed
+    {
+      if (data.animating)
+        return;
+      data.animating = true;
+      data.animation_start_time = std::chrono::steady_clock::now();
+    }
+
+    static void StopAnimation(CSF_data &data)
+    {
+      data.animating = false;
+    }
+
+    static constexpr auto window_name = "Contrast sensitivity function";
+    static constexpr auto animate_checkbox_name = "Animate";
+  public:
+    CSF_data(const int width, const int height)
+     : window(window_name),
+       animate_checkbox(animate_checkbox_name, window, false, Animate, StopAnimation, *this), //Not animated by default
+       amplitudes(height),
+       phase_sines(width),
+       phase_cosines(width),
+       column_values(width),
+       image(height, width),
+       animating(false)
+    {
+      assert(IsWidthSupported(width) && height > 0);
+      InitializeTables(width, height);
+      UpdateImage(); //Update with default values
+    }
+
+    //Returns whether the frequencies can increase from left to right for the given width
+    static bool IsWidthSupported(const int width)
+    {
+      return GetMaxFrequency(width) > min_frequency;
+    }
+
+    void ShowImage()
+    {
+      while (window.ShowInteractive(nullptr, frame_delay, false) == -1) //Do not hide the window after each frame; continue until a key is pressed
+      {
+        if (animating)
+          UpdateAnimation();
+      }
+      window.Hide();
+      animating = false;
+    }
+};
+
+static void ShowContrastSensitivityFunction(const int width, const int height)
 {
-  constexpr auto window_name = "Contrast sensitivity function";
-  const cv::Mat csf_image = GenerateCSFImage();
-  imgutils::Window window(window_name, csf_image);
-  window.ShowInteractive();
+  CSF_data data(width, height);
+  data.ShowImage();
 }
 
 int main(const int argc, const char * const argv[])
 {
-  if (argc != 1)
+  if (argc != 1 && argc != 3)
   {
     std::cout << "Illustrates the contrast sensitivity function." << std::endl;
-    std::cout << "Usage: " << argv[0] << std::endl;
+    std::cout << "Usage: " << argv[0] << " [<width> <height>]" << std::endl;
     return 1;
   }
-  ShowContrastSensitivityFunction();
+  int width = 800;
+  int height = 600;
+  if (argc == 3)
+  {
+    try
+    {
+      const auto width_text = argv[1];
+      width = std::stoi(width_text);
+      const auto height_text = argv[2];
+      height = std::stoi(height_text);
+    }
+    catch (const std::logic_error &) //Invalid or out-of-range numbers
+    {
+      std::cerr << "Width and height must be integers" << std::endl;
+      std::cout << "Usage: " << argv[0] << " [<width> <height>]" << std::endl;
+      return 1;
+    }
+    if (!CSF_data::IsWidthSupported(width) || height <= 0)
+    {
+      std::cerr << "Width must be large enough for the frequencies to increase from left to right (at least 11), and height must be positive" << std::endl;
+      return 2;
+    }
+  }
+  ShowContrastSensitivityFunction(width, height);
   return 0;
 }
@@ -1,5 +1,5 @@
 //Illustration of the decomposition of a block into 2-D DCT basis functions and their recomposition
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -11,9 +11,14 @@
 #include <opencv2/imgproc.hpp>
 
 #include "math.hpp"
+#include "bitwriter.hpp"
 #include "imgmath.hpp"
+#include "entropy.hpp"
 #include "colors.hpp"
 #include "combine.hpp"
+#include "canvas.hpp"
+#include "framearena.hpp"
+#include "trace.hpp"
 #include "format.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
@@ -31,6 +36,7 @@ class DCT_data
     static const cv::Size displayed_window_size; //Defined below
   protected:
     imgutils::Window decomposition_window;
+    imgutils::Canvas decomposition_canvas; //Image block (left) and its decomposition (right)
     
     using TrackBarType = imgutils::TrackBar<DCT_data&>;
     TrackBarType block_size_trackbar;
@@ -43,6 +49,7 @@ class DCT_data
     MouseEventType decomposition_mouse_event;
     
     imgutils::Window detail_window;
+    imgutils::Canvas detail_canvas; //Basis function (left) and weighted basis function (right)
     
     imgutils::Window sum_window;
     
@@ -51,6 +58,12 @@ class DCT_data
     const cv::Mat image;
     std::atomic_bool running;
     
+    cv::Mat scaling_factors; //Coefficient scaling factors for the current block size
+    cv::Mat block_coefficients; //Temporary buffers for entropy coding (reused for all blocks)
+    cv::Mat quantized_block_coefficients;
+    comutils::BitWriter bit_writer;
+    std::string entropy_coding_status;
+    
     unsigned int GetBlockSize()
     {
       const auto log_block_size = block_size_trackbar.GetValue();
@@ -61,13 +74,13 @@ class DCT_data
     {
       assert(image.cols == image.rows);
       const unsigned int block_size = static_cast<unsigned int>(image.rows);
-      const cv::Mat shifted_image = imgutils::ImageLevelShift(image);
-      cv::dct(shifted_image, raw_coefficients);
+      imgutils::LevelShiftedDCT(image, raw_coefficients);
       raw_coefficients.forEach([block_size](double &value, const int position[])
                                            {
                                              value *= comutils::Get2DDCTCoefficientScalingFactor(block_size, position[0], position[1]);
                                            });
-      cv::Mat decomposed_image = imgutils::ReverseImageLevelShift(raw_coefficients);
+      cv::Mat decomposed_image;
+      imgutils::ReverseImageLevelShift(raw_coefficients, decomposed_image);
       return decomposed_image;
     }
 
@@ -88,9 +101,11 @@ class DCT_data
       cv::Mat_<double> coefficients;
       const cv::Mat decomposed_image = Decompose(image_part, coefficients);
       const cv::Mat decomposed_image_highlighted = HighlightCoefficient(decomposed_image, highlighted_x_index, highlighted_y_index);
-      const cv::Mat combined_image = imgutils::CombineImages({image_part, decomposed_image_highlighted}, imgutils::CombinationMode::Horizontal, 1);
+      const cv::Mat &combined_image = imgutils::CombineImages({image_part, decomposed_image_highlighted}, decomposition_canvas, imgutils::CombinationMode::Horizontal, 1);
       decomposition_window.UpdateContent(combined_image);
       decomposition_window.SetSize(displayed_window_size);
+      if (decomposition_window.IsShown())
+        decomposition_window.ShowOverlayText(entropy_coding_status, true);
       return coefficients(highlighted_y_index, highlighted_x_index);
     }
 
@@ -102,7 +117,7 @@ class DCT_data
       const cv::Mat basis_function = imgutils::Get2DDCTBasisFunctionImage(block_size, y_index, x_index);
       const cv::Mat raw_weighted_basis_function = imgutils::GetRaw2DDCTBasisFunctionImage(block_size, y_index, x_index, sanitized_shifted_value); //For calculating sums (not for illustration)
       const cv::Mat weighted_basis_function = imgutils::Get2DDCTBasisFunctionImage(block_size, y_index, x_index, sanitized_shifted_value);
-      const cv::Mat combined_image = imgutils::CombineImages({basis_function, weighted_basis_function}, imgutils::CombinationMode::Horizontal, 1);
+      const cv::Mat &combined_image = imgutils::CombineImages({basis_function, weighted_basis_function}, detail_canvas, imgutils::CombinationMode::Horizontal, 1);
       detail_window.UpdateContent(combined_image);
       detail_window.SetSize(displayed_window_size);
       if (detail_window.IsShown())
@@ -121,9 +136,55 @@ class DCT_data
       const cv::Mat center_block = image(center_rect);
       return center_block;
     }
+    
+    void SetScalingFactors(const unsigned int block_size)
+    {
+      cv::Mat_<double> block_scaling_factors(block_size, block_size);
+      block_scaling_factors.forEach([block_size](double &value, const int position[])
+                                                {
+                                                  value = comutils::Get2DDCTCoefficientScalingFactor(block_size, position[0], position[1]);
+                                                });
+      scaling_factors = block_scaling_factors;
+    }
+    
+    size_t EncodeBlock(const cv::Mat &block, imgutils::BlockEntropyCoder &coder)
+    {
+      imgutils::LevelShiftedDCT(block, block_coefficients);
+      cv::multiply(block_coefficients, scaling_factors, block_coefficients); //Scale like in Decompose
+      block_coefficients.convertTo(quantized_block_coefficients, CV_16S); //Round to integers, i.e., quantize with a step size of 1
+      return coder.EncodeBlock(quantized_block_coefficients, bit_writer);
+    }
+    
+    size_t EncodeImage(imgutils::BlockEntropyCoder &coder)
+    {
+      const int block_size = coder.GetBlockSize();
+      bit_writer.Clear();
+      for (int y = 0; y + block_size <= image.rows; y += block_size) //Only complete blocks are coded
+      {
+        for (int x = 0; x + block_size <= image.cols; x += block_size)
+          EncodeBlock(image(cv::Rect(x, y, block_size, block_size)), coder);
+      }
+      bit_writer.Flush();
+      return bit_writer.GetBitCount();
+    }
+    
+    void UpdateEntropyCodingStatistics()
+    {
+      const auto block_size = GetBlockSize();
+      SetScalingFactors(block_size);
+      imgutils::BlockEntropyCoder coder(block_size);
+      bit_writer.Clear();
+      const auto block_bits = EncodeBlock(GetCenterBlock(), coder);
+      coder.ResetDCPrediction();
+      const auto image_bits = EncodeImage(coder);
+      const auto coded_pixels = (image.rows / block_size) * (image.cols / block_size) * block_size * block_size;
+      entropy_coding_status = "Entropy-coded block: " + std::to_string(block_bits) + " bits (" + comutils::FormatValue(static_cast<double>(block_bits) / (block_size * block_size)) + " bpp), "
+                              "image: " + comutils::FormatByte((image_bits + 7) / 8) + " (" + comutils::FormatValue(static_cast<double>(image_bits) / coded_pixels) + " bpp)";
+    }
 
     cv::Mat SetFocusedCoefficient(const unsigned int x_index, const unsigned int y_index)
     {
+      const comutils::TraceScope trace_scope("SetFocusedCoefficient");
       const auto value = UpdateImageAndDCT(x_index, y_index);
       const auto raw_weighted_basis_function_image = UpdateWeightedBasisFunctionImage(x_index, y_index, value);
       return raw_weighted_basis_function_image;
@@ -137,84 +198,35 @@ class DCT_data
       sum_window.SetSize(displayed_window_size);
       if (sum_window.IsShown())
         sum_window.ShowOverlayText("Please start adding via the corresponding button.", true);
+      UpdateEntropyCodingStatistics();
       SetFocusedCoefficient(0, 0); //Set focus to DC coefficient
     }
     
     static void UpdateImages(DCT_data &data)
     {
+      const comutils::TraceScope trace_scope("UpdateImages");
       data.running = false; //Make sure the animation is stopped
       data.ResetWindows();
     }
     
-    using coefficient_index = std::pair<size_t, size_t>;
-
-    std::vector<coefficient_index> ZigZagScanIndices()
-    {
-      const auto block_size = GetBlockSize();
-      assert(block_size >= 1);
-      size_t x = 0, y = 0;
-      bool up = true;
-      std::vector<coefficient_index> indices;
-      indices.reserve(block_size * block_size);
-      indices.push_back(coefficient_index(0, 0));
-      while (!(x == block_size - 1 && y == block_size - 1))
-      {
-        while(up)
-        {
-          if (y == 0 || x == block_size - 1)
-          {
-            if (y == 0)
-              x++;
-            else if (x == block_size - 1)
-              y++;
-            indices.push_back(coefficient_index(x, y));
-            up = false;
-          }
-          else
-          {
-            x++;
-            y--;
-            indices.push_back(coefficient_index(x, y));
-          }
-        }
-        while (!up)
-        {
-          if (x == 0 || y == block_size - 1)
-          {
-            if (y == block_size - 1)
-              x++;
-            else if (x == 0)
-              y++;
-            indices.push_back(coefficient_index(x, y));
-            up = true;
-          }
-          else
-          {
-            x--;
-            y++;
-            indices.push_back(coefficient_index(x, y));
-          }
-        }
-      }
-      return indices;
-    }
-    
     void AddWeightedBasisFunctions()
     {
       constexpr auto step_delay = 5000; //Animation delay in ms
       const int block_size = GetBlockSize();
       cv::Mat raw_sum(block_size, block_size, CV_64FC1, cv::Scalar(0.0)); //Initialize sum with zeros
+      cv::Mat sum; //Level-shifted sum (reused for all coefficients)
       unsigned int coefficient = 0;
-      const auto indices = ZigZagScanIndices();
+      const auto indices = imgutils::ZigZagScanIndices(block_size);
       for (const auto &index : indices)
       {
         if (!running) //Skip the rest when the user aborts
           return;
+        const imgutils::FrameArenaScope frame_scope; //Temporary images of each step are taken from an arena which is reused by the next step
         const auto x = index.first;
         const auto y = index.second;
         const auto raw_weighted_basis_function_image = SetFocusedCoefficient(x, y);
         raw_sum += raw_weighted_basis_function_image; //Add image to sum
-        const cv::Mat sum = imgutils::ReverseImageLevelShift(raw_sum);
+        imgutils::ReverseImageLevelShift(raw_sum, sum);
         sum_window.UpdateContent(sum);
         sum_window.SetSize(displayed_window_size);
         coefficient++;
@@ -1,18 +1,20 @@
 //Illustration of JPEG quality levels
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
-#include <opencv2/imgproc.hpp>
 
+#include "canvas.hpp"
 #include "combine.hpp"
 #include "format.hpp"
+#include "trace.hpp"
 #include "imgmath.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
+#include "yuvimage.hpp"
 
 class JPEG_data
 {
@@ -27,35 +29,37 @@ class JPEG_data
     imgutils::MultiWindow all_windows;
   
     const cv::Mat image;
+    const imgutils::YUVImage image_y; //Luminance of the uncompressed image
+    imgutils::YUVImage compressed_image_y; //Luminance of the compressed image, reused between updates
+    cv::Mat difference_image; //Reused between updates
+    std::vector<uchar> compressed_bits; //Reused between updates
+    imgutils::Canvas canvas; //Uncompressed (left) and compressed image (right)
     
-    cv::Mat CompressImage(const unsigned char quality, unsigned int &compressed_size)
+    void CompressImage(const unsigned char quality, cv::Mat &compressed_image, unsigned int &compressed_size)
     {
       assert(quality <= 100);
-      std::vector<uchar> compressed_bits;
       assert(imencode(".jpg", image, compressed_bits, std::vector<int>({cv::ImwriteFlags::IMWRITE_JPEG_QUALITY, quality, cv::ImwriteFlags::IMWRITE_JPEG_OPTIMIZE, 1})));
       compressed_size = compressed_bits.size();
-      const cv::Mat compressed_image = cv::imdecode(compressed_bits, cv::ImreadModes::IMREAD_COLOR);
+      cv::imdecode(compressed_bits, cv::ImreadModes::IMREAD_COLOR, &compressed_image); //Decodes into the existing image since its size and type match
       assert(!compressed_image.empty());
-      return compressed_image;
-    }
-    
-    static cv::Mat GetYChannelFromRGBImage(const cv::Mat &image)
-    {
-      cv::Mat gray;
-      cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY); //Identical to cv::COLOR_BGR2YCrCb with just the luma channel (see https://docs.opencv.org/master/de/d25/imgproc_color_conversions.html#color_convert_rgb_ycrcb)
-      return gray;
     }
     
     void UpdateDifferenceImage(const cv::Mat &compressed_image)
     {
-      const cv::Mat image_y = GetYChannelFromRGBImage(image);
-      const cv::Mat compressed_image_y = GetYChannelFromRGBImage(compressed_image);
-      const cv::Mat difference_y = imgutils::SubtractImages(compressed_image_y, image_y);
-      difference_window.UpdateContent(imgutils::ConvertDifferenceImage(difference_y));
+      compressed_image_y.ConvertFrom(compressed_image, imgutils::ChromaFormat::Format400); //Only the luma channel is required
+      const cv::Mat difference_y = imgutils::SubtractImages(compressed_image_y.GetPlane(imgutils::Plane::Y), image_y.GetPlane(imgutils::Plane::Y));
+      imgutils::ConvertDifferenceImage(difference_y, difference_image);
+      difference_window.UpdateContent(difference_image);
       if (difference_window.IsShown())
       {
-        const double YPSNR = imgutils::PSNR(imgutils::MSE(difference_y));
-        const std::string status_text = "Y-PSNR: " + comutils::FormatLevel(YPSNR);
+        const double YPSNR = imgutils::PSNR(compressed_image_y.GetPlane(imgutils::Plane::Y), image_y.GetPlane(imgutils::Plane::Y));
+        std::string status_text = "Y-PSNR: " + comutils::FormatLevel(YPSNR);
+        if (imgutils::IsSSIMSupported(image_y.GetSize())) //Very small images have no SSIM
+        {
+          const double YSSIM = imgutils::SSIM(compressed_image_y.GetPlane(imgutils::Plane::Y), image_y.GetPlane(imgutils::Plane::Y));
+          const double YMSSSIM = imgutils::MSSSIM(compressed_image_y.GetPlane(imgutils::Plane::Y), image_y.GetPlane(imgutils::Plane::Y));
+          status_text += ", Y-SSIM: " + comutils::FormatValue(YSSIM, 4) + ", Y-MS-SSIM: " + comutils::FormatValue(YMSSSIM, 4);
+        }
         difference_window.ShowOverlayText(status_text);
       }
     }
@@ -65,9 +69,9 @@ class JPEG_data
       const auto quality = quality_trackbar.GetValue();
       const auto uncompressed_size = image.total() * image.elemSize();
       unsigned int compressed_size;
-      cv::Mat compressed_image = CompressImage(quality, compressed_size);
-      const cv::Mat combined_image = imgutils::CombineImages({image, compressed_image}, imgutils::CombinationMode::Horizontal);
-      image_window.UpdateContent(combined_image);
+      cv::Mat compressed_image = canvas.GetTile(1);
+      CompressImage(quality, compressed_image, compressed_size);
+      image_window.UpdateContent(canvas.GetImage());
       if (image_window.IsShown())
       {
         const std::string status_text = comutils::FormatByte(uncompressed_size) + " vs. " + comutils::FormatByte(compressed_size);
@@ -78,6 +82,7 @@ class JPEG_data
 
     static void UpdateImages(JPEG_data &data)
     {
+      const comutils::TraceScope trace_scope("UpdateImages");
       const cv::Mat compressed_image = data.UpdateCompressedImage();
       data.UpdateDifferenceImage(compressed_image);
     }
@@ -91,8 +96,11 @@ class JPEG_data
        quality_trackbar(quality_trackbar_name, image_window, 100, 0, 50, UpdateImages, *this), //50% quality by default
        difference_window(difference_window_name),
        all_windows({&image_window, &difference_window}, imgutils::WindowAlignment::Horizontal), //TODO: Align vertically, but right-aligned instead of left-aligned
-       image(image)
+       image(image),
+       image_y(image, imgutils::ChromaFormat::Format400),
+       canvas(image.size(), 2, imgutils::CombinationMode::Horizontal)
     {
+      canvas.UpdateTile(0, image); //The uncompressed image does not change
       image_window.SetAlwaysShowEnhanced(); //This window needs to be enhanced to show overlays
       difference_window.SetAlwaysShowEnhanced(); //This window needs to be enhanced to show overlays
       UpdateImages(*this); //Update with default values
@@ -0,0 +1,277 @@
+//Rate-distortion analysis of JPEG compression over a set of images
+// Andreas Unterweger, 2026
+//This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
+
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "common.hpp"
+#include "cpudispatch.hpp"
+#include "format.hpp"
+#include "imgmath.hpp"
+#include "threadpool.hpp"
+#include "trace.hpp"
+
+struct sampling_format
+{
+  const char * const name;
+  const int sampling_factor; //Value for IMWRITE_JPEG_SAMPLING_FACTOR
+
+  constexpr sampling_format(const char * const name, const int sampling_factor)
+   : name(name), sampling_factor(sampling_factor) { }
+};
+
+static constexpr const sampling_format sampling_formats[] {sampling_format("4:4:4", cv::IMWRITE_JPEG_SAMPLING_FACTOR_444),
+                                                           sampling_format("4:2:2", cv::IMWRITE_JPEG_SAMPLING_FACTOR_422),
+                                                           sampling_format("4:1:1", cv::IMWRITE_JPEG_SAMPLING_FACTOR_411),
+                                                           sampling_format("4:2:0", cv::IMWRITE_JPEG_SAMPLING_FACTOR_420)};
+static constexpr auto &reference_format = sampling_formats[0]; //BD-rates are calculated relative to 4:4:4
+static constexpr int qualities[] {5, 10, 20, 30, 40, 50, 60, 70, 80, 90, 95};
+
+static constexpr size_t format_count = comutils::arraysize(sampling_formats);
+static constexpr size_t quality_count = comutils::arraysize(qualities);
+static constexpr size_t settings_per_image = format_count * quality_count;
+
+//Result of loading an image (one byte each since the tasks write concurrently)
+enum class ImageStatus : unsigned char
+{
+  Unreadable, //Could not be read as an image
+  TooSmall, //Too small for SSIM
+  Loaded //Can be encoded and measured
+};
+
+struct rd_point
+{
+  size_t bytes;
+  double PSNR;
+  double SSIM;
+};
+
+static rd_point EncodeAndMeasure(const cv::Mat &image, const sampling_format &format, const int quality)
+{
+  const comutils::TraceScope trace_scope("EncodeAndMeasure");
+  std::vector<uchar> compressed_bits;
+  cv::imencode(".jpg", image, compressed_bits, std::vector<int>({cv::ImwriteFlags::IMWRITE_JPEG_QUALITY, quality, cv::ImwriteFlags::IMWRITE_JPEG_SAMPLING_FACTOR, format.sampling_factor, cv::ImwriteFlags::IMWRITE_JPEG_OPTIMIZE, 1}));
+  const cv::Mat compressed_image = cv::imdecode(compressed_bits, cv::ImreadModes::IMREAD_COLOR);
+  assert(!compressed_image.empty());
+  return rd_point {compressed_bits.size(), imgutils::PSNR(image, compressed_image), imgutils::SSIM(image, compressed_image)};
+}
+
+//Encodes all images with all settings. Each combination of image and setting is a separate task which is queued as soon as the image has been loaded. To hold only few images in memory, at most as many images as there are threads are loaded at once: the next image is only loaded when a loaded image has been encoded with all settings or cannot be used.
+static void EncodeImages(const std::vector<cv::String> &filenames, std::vector<ImageStatus> &statuses, std::vector<rd_point> &points, std::vector<double> &pixel_counts)
+{
+  const size_t image_count = filenames.size();
+  statuses.assign(image_count, ImageStatus::Unreadable);
+  points.resize(image_count * settings_per_image);
+  pixel_counts.assign(image_count, 0);
+  std::vector<cv::Mat> images(image_count); //Only the images which are currently being encoded are not empty
+  std::vector<std::atomic<size_t>> remaining_settings(image_count); //Number of settings per image which have not been encoded yet
+  std::atomic<size_t> next_image(0);
+  comutils::TaskGroup group;
+  std::function<void()> load_next_image;
+  const auto release_image = [&](const size_t i)
+                                                {
+                                                  images[i].release(); //Free the memory before the next image is loaded
+                                                  load_next_image();
+                                                };
+  load_next_image = [&]()
+                         {
+                           const size_t i = next_image.fetch_add(1, std::memory_order_relaxed);
+                           if (i >= image_count)
+                             return;
+                           group.Run([&, i]()
+                                              {
+                                                const comutils::TraceScope trace_scope("LoadImage");
+                                                images[i] = cv::imread(filenames[i], cv::IMREAD_COLOR);
+                                                pixel_counts[i] = images[i].total();
+                                                if (!images[i].empty())
+                                                  statuses[i] = imgutils::IsSSIMSupported(images[i].size()) ? ImageStatus::Loaded : ImageStatus::TooSmall;
+                                                if (statuses[i] != ImageStatus::Loaded)
+                                                {
+                                                  release_image(i);
+                                                  return;
+                                                }
+                                                remaining_settings[i].store(settings_per_image, std::memory_order_relaxed);
+                                                for (size_t setting = 0; setting < settings_per_image; setting++) //Queued on this thread's queue so that idle threads can steal them
+                                                {
+                                                  group.Run([&, i, setting]()
+                                                                             {
+                                                                               const auto &format = sampling_formats[setting / quality_count];
+                                                                               const auto quality = qualities[setting % quality_count];
+                                                                               points[i * settings_per_image + setting] = EncodeAndMeasure(images[i], format, quality);
+                                                                               if (remaining_settings[i].fetch_sub(1, std::memory_order_acq_rel) == 1) //All other settings have finished reading the image
+                                                                                 release_image(i);
+                                                                             });
+                                                }
+                                              });
+                         };
+  const size_t max_loaded_images = comutils::ThreadPool::GetDefault().GetThreadCount();
+  for (size_t i = 0; i < std::min(max_loaded_images, image_count); i++)
+    load_next_image();
+  group.Wait();
+}
+
+static void WriteCSV(std::ostream &stream, const std::vector<cv::String> &filenames, const std::vector<ImageStatus> &statuses, const std::vector<rd_point> &points, const std::vector<double> &pixel_counts)
+{
+  stream << "image,format,quality,bytes,bpp,psnr,ssim" << std::endl;
+  for (size_t i = 0; i < filenames.size(); i++)
+  {
+    if (statuses[i] != ImageStatus::Loaded)
+      continue;
+    for (size_t setting = 0; setting < settings_per_image; setting++)
+    {
+      const auto &point = points[i * settings_per_image + setting];
+      const auto bits_per_pixel = (8.0 * point.bytes) / pixel_counts[i];
+      stream << filenames[i] << "," << sampling_formats[setting / quality_count].name << "," << qualities[setting % quality_count] << "," << point.bytes << ","
+             << comutils::FormatValue(bits_per_pixel, 4) << "," << comutils::FormatValue(point.PSNR, 4) << "," << comutils::FormatValue(point.SSIM, 6) << std::endl;
+    }
+  }
+}
+
+//Fits a cubic polynomial p(x) = c0 + c1 * x + c2 * x^2 + c3 * x^3 to the specified points in the least-squares sense
+static cv::Vec4d FitCubicPolynomial(const std::vector<double> &x, const std::vector<double> &y)
+{
+  assert(x.size() == y.size() && x.size() >= 4);
+  cv::Mat_<double> powers(x.size(), 4);
+  for (size_t i = 0; i < x.size(); i++)
+  {
+    double power = 1;
+    for (int j = 0; j < 4; j++, power *= x[i])
+      powers(i, j) = power;
+  }
+  cv::Mat_<double> coefficients;
+  cv::solve(powers, cv::Mat_<double>(y, false), coefficients, cv::DECOMP_SVD);
+  return cv::Vec4d(coefficients(0), coefficients(1), coefficients(2), coefficients(3));
+}
+
+//Calculates the definite integral of a cubic polynomial (see FitCubicPolynomial) between the specified bounds
+static double IntegrateCubicPolynomial(const cv::Vec4d &coefficients, const double lower_bound, const double upper_bound)
+{
+  const auto antiderivative = [&coefficients](const double x)
+                                             {
+                                               return x * (coefficients[0] + x * (coefficients[1] / 2 + x * (coefficients[2] / 3 + x * coefficients[3] / 4)));
+                                             };
+  return antiderivative(upper_bound) - antiderivative(lower_bound);
+}
+
+//Calculates the Bjøntegaard delta rate (average rate difference at equal PSNR in percent) of the test points relative to the reference points. Returns NaN if there are not enough points or the PSNR ranges do not overlap.
+static double CalculateBDRate(const rd_point reference_points[], const rd_point test_points[], const size_t N)
+{
+  std::vector<double> reference_PSNRs, reference_log_rates, test_PSNRs, test_log_rates;
+  for (size_t i = 0; i < N; i++)
+  {
+    if (std::isfinite(reference_points[i].PSNR)) //Lossless results cannot be fitted
+    {
+      reference_PSNRs.push_back(reference_points[i].PSNR);
+      reference_log_rates.push_back(std::log(reference_points[i].bytes));
+    }
+    if (std::isfinite(test_points[i].PSNR))
+    {
+      test_PSNRs.push_back(test_points[i].PSNR);
+      test_log_rates.push_back(std::log(test_points[i].bytes));
+    }
+  }
+  if (reference_PSNRs.size() < 4 || test_PSNRs.size() < 4)
+    return std::numeric_limits<double>::quiet_NaN();
+  const auto min_PSNR = std::max(*std::min_element(reference_PSNRs.begin(), reference_PSNRs.end()), *std::min_element(test_PSNRs.begin(), test_PSNRs.end()));
+  const auto max_PSNR = std::min(*std::max_element(reference_PSNRs.begin(), reference_PSNRs.end()), *std::max_element(test_PSNRs.begin(), test_PSNRs.end()));
+  if (max_PSNR <= min_PSNR)
+    return std::numeric_limits<double>::quiet_NaN();
+  const auto reference_fit = FitCubicPolynomial(reference_PSNRs, reference_log_rates);
+  const auto test_fit = FitCubicPolynomial(test_PSNRs, test_log_rates);
+  const auto average_log_rate_difference = (IntegrateCubicPolynomial(test_fit, min_PSNR, max_PSNR) - IntegrateCubicPolynomial(reference_fit, min_PSNR, max_PSNR)) / (max_PSNR - min_PSNR);
+  return (std::exp(average_log_rate_difference) - 1) * 100;
+}
+
+static void PrintBDRates(const std::vector<ImageStatus> &statuses, const std::vector<rd_point> &points)
+{
+  const size_t reference_format_index = &reference_format - sampling_formats;
+  std::cout << "Mean BD-rate relative to " << reference_format.name << " (negative values indicate savings):" << std::endl;
+  for (size_t format_index = 0; format_index < format_count; format_index++)
+  {
+    if (format_index == reference_format_index)
+      continue;
+    double BD_rate_sum = 0;
+    unsigned int BD_rate_count = 0;
+    for (size_t i = 0; i < statuses.size(); i++)
+    {
+      if (statuses[i] != ImageStatus::Loaded)
+        continue;
+      const auto image_points = &points[i * settings_per_image];
+      const auto BD_rate = CalculateBDRate(image_points + reference_format_index * quality_count, image_points + format_index * quality_count, quality_count);
+      if (!std::isnan(BD_rate))
+      {
+        BD_rate_sum += BD_rate;
+        BD_rate_count++;
+      }
+    }
+    std::cout << sampling_formats[format_index].name << ": ";
+    if (BD_rate_count)
+      std::cout << comutils::FormatValue(BD_rate_sum / BD_rate_count) << "% (" << BD_rate_count << " images)" << std::endl;
+    else
+      std::cout << "n/a" << std::endl;
+  }
+}
+
+static int AnalyzeImages(const char * const input_folder, const char * const csv_filename)
+{
+  std::vector<cv::String> filenames;
+  cv::glob(input_folder, filenames, false);
+  if (filenames.empty())
+  {
+    std::cerr << "Could not find any files in '" << input_folder << "'" << std::endl;
+    return 2;
+  }
+  std::vector<ImageStatus> statuses;
+  std::vector<rd_point> points;
+  std::vector<double> pixel_counts;
+  const auto start_time = std::chrono::steady_clock::now();
+  EncodeImages(filenames, statuses, points, pixel_counts);
+  const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+  for (size_t i = 0; i < filenames.size(); i++)
+  {
+    if (statuses[i] == ImageStatus::Unreadable)
+      std::cerr << "Skipped '" << filenames[i] << "' since it could not be read as an image" << std::endl;
+    else if (statuses[i] == ImageStatus::TooSmall)
+      std::cerr << "Skipped '" << filenames[i] << "' since it is too small to calculate its SSIM" << std::endl;
+  }
+  const auto image_count = std::count(statuses.begin(), statuses.end(), ImageStatus::Loaded);
+  std::cout << "Encoded " << image_count << " images with " << settings_per_image << " settings each in " << comutils::FormatValue(duration.count()) << " s using " << comutils::ThreadPool::GetDefault().GetThreadCount() << " threads and " << comutils::GetCPUTargetName(comutils::GetCPUTarget()) << " kernels" << std::endl;
+  if (csv_filename)
+  {
+    std::ofstream csv_file(csv_filename);
+    if (!csv_file)
+    {
+      std::cerr << "Could not write to '" << csv_filename << "'" << std::endl;
+      return 3;
+    }
+    WriteCSV(csv_file, filenames, statuses, points, pixel_counts);
+  }
+  PrintBDRates(statuses, points);
+  return 0;
+}
+
+int main(const int argc, const char * const argv[])
+{
+  if (argc != 2 && argc != 3)
+  {
+    std::cout << "Compresses all images in a folder with different JPEG quality levels and chrominance subsamplings, reporting rate-distortion points and BD-rates." << std::endl;
+    std::cout << "Usage: " << argv[0] << " <input folder> [<output CSV file>]" << std::endl;
+    return 1;
+  }
+  const auto input_folder = argv[1];
+  const auto csv_filename = argc == 3 ? argv[2] : nullptr;
+  return AnalyzeImages(input_folder, csv_filename);
+}
@@ -1,30 +1,31 @@
 //Illustration of RGB and YCbCr component decomposition
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
+#include <algorithm>
 
 #include <opencv2/core.hpp>
 #include <opencv2/imgcodecs.hpp>
-#include <opencv2/imgproc.hpp>
 
-#include "combine.hpp"
+#include "canvas.hpp"
 #include "window.hpp"
+#include "ycbcr.hpp"
 
 static void ShowImage(const cv::Mat &image)
 {
   constexpr auto window_name = "RGB vs. YCbCr";
-  cv::Mat bgr_planes[3];
-  cv::split(image, bgr_planes);
-  cv::Mat ycrcb_image;
-  cv::cvtColor(image, ycrcb_image, cv::COLOR_BGR2YCrCb); //TODO: Allow subsampling (how? cv::cvtColor makes a 1-channel matrix with cv::COLOR_BGR2YUV_*)
-  cv::Mat ycrcb_planes[3];
-  cv::split(ycrcb_image, ycrcb_planes);
-  const cv::Mat rgb_planes_combined = imgutils::CombineImages({image, bgr_planes[2], bgr_planes[1], bgr_planes[0]}, imgutils::CombinationMode::Horizontal); //BGR as RGB
-  const cv::Mat ycbcr_planes_combined = imgutils::CombineImages({image, ycrcb_planes[0], ycrcb_planes[2], ycrcb_planes[1]}, imgutils::CombinationMode::Horizontal); //YCrCb as YCbCr
-  cv::Mat combined_images = imgutils::CombineImages({rgb_planes_combined, ycbcr_planes_combined}, imgutils::CombinationMode::Vertical);
-  cv::resize(combined_images, combined_images, cv::Size(), 1 / sqrt(2), 1 / sqrt(2), cv::INTER_LANCZOS4); //TODO: Don't resize, but find another way to fit the window(s) to the screen size, e.g., by allowing to hide the original image via a checkbox
-  imgutils::Window window(window_name, combined_images);
+  constexpr int max_width = 1920; //Maximum width of the combined images so that the window fits the screen
+  constexpr int border_size = 3; //Width of the black bars between the images
+  constexpr int images_per_row = 4; //Original image and its three components
+  const int downscaling_factor = std::max(1, (images_per_row * image.cols + (images_per_row - 1) * border_size + max_width - 1) / max_width); //TODO: Find another way to fit the window(s) to the screen size, e.g., by allowing to hide the original image via a checkbox
+  const auto size = imgutils::GetDownscaledSize(image.size(), downscaling_factor);
+  imgutils::Canvas canvas(size, images_per_row, 2, border_size); //RGB on top, YCbCr below
+  cv::Mat downscaled_image = canvas.GetTile(0, 0);
+  cv::Mat components[] {canvas.GetTile(1, 0), canvas.GetTile(2, 0), canvas.GetTile(3, 0), canvas.GetTile(1, 1), canvas.GetTile(2, 1), canvas.GetTile(3, 1)};
+  imgutils::DecomposeBGRImage(image, downscaled_image, components, downscaling_factor); //Write all components directly into the canvas
+  canvas.UpdateTile(images_per_row, downscaled_image); //Repeat the original image at the start of the second row
+  imgutils::Window window(window_name, canvas.GetImage());
   window.ShowInteractive();
 }
 
@@ -1,5 +1,5 @@
 //Illustration of Haar features for object detection
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -10,6 +10,7 @@
 #include <opencv2/imgproc.hpp>
 
 #include "format.hpp"
+#include "trace.hpp"
 #include "colors.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
@@ -103,6 +104,7 @@ class haar_data
 
     double UpdateImage(const bool update_GUI = true)
     {
+      const comutils::TraceScope trace_scope("UpdateImage");
       const cv::Mat block_pixels = original_image(current_block);
       const double feature_value = GetFeatureValue(block_pixels);
       if (update_GUI)
@@ -143,6 +145,7 @@ class haar_data
     
     cv::Mat_<double> PerformSearch(const bool update_GUI = true)
     {
+      const comutils::TraceScope trace_scope("PerformSearch");
       constexpr auto search_step_delay = 1; //Animation delay in ms
       cv::Mat_<double> score_map(original_image.size(), std::numeric_limits<double>::infinity());
       for (int y = border_size; y <= original_image.cols - static_cast<int>(block_height + border_size); y++)
@@ -1,5 +1,5 @@
 //Illustration of intra prediction and the effect of residuals on transforms
-// Andreas Unterweger, 2017-2022
+// Andreas Unterweger, 2017-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -14,7 +14,9 @@
 #include "math.hpp"
 #include "imgmath.hpp"
 #include "combine.hpp"
+#include "canvas.hpp"
 #include "format.hpp"
+#include "trace.hpp"
 #include "colors.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
@@ -103,10 +105,12 @@ class prediction_data
     std::unique_ptr<RadioButtonType> prediction_method_radiobuttons[comutils::arraysize(prediction_methods)];
     
     imgutils::Window transformed_window;
+    imgutils::Canvas transformed_canvas; //Original block (left) and its decomposition (right)
     
     imgutils::Window predicted_window;
     
     imgutils::Window predicted_transformed_window;
+    imgutils::Canvas predicted_transformed_canvas; //Prediction error (left) and its decomposition (right)
     
     imgutils::Window prediction_window;
     
@@ -191,13 +195,13 @@ class prediction_data
     {
       assert(image.cols == image.rows);
       assert(image.cols == block_size);
-      const cv::Mat shifted_image = imgutils::ImageLevelShift(image);
-      dct(shifted_image, raw_coefficients);
+      imgutils::LevelShiftedDCT(image, raw_coefficients);
       raw_coefficients.forEach([](double &value, const int position[])
                                  {
                                    value *= comutils::Get2DDCTCoefficientScalingFactor(block_size, position[0], position[1]);
                                  });
-      cv::Mat decomposed_image = imgutils::ReverseImageLevelShift(raw_coefficients);
+      cv::Mat decomposed_image;
+      imgutils::ReverseImageLevelShift(raw_coefficients, decomposed_image);
       return decomposed_image;
     }
 
@@ -213,7 +217,7 @@ class prediction_data
       return percentage_small_coefficients;
     }
 
-    static void ShowDifferenceAndDCT(const cv::Mat image, imgutils::Window &window, const unsigned int zoom_factor, bool image_is_difference = false)
+    static void ShowDifferenceAndDCT(const cv::Mat image, imgutils::Window &window, imgutils::Canvas &canvas, const unsigned int zoom_factor, bool image_is_difference = false)
     {
       constexpr auto absolute_threshhold = 5.0;
       
@@ -221,7 +225,7 @@ class prediction_data
       const cv::Mat dct_input_image = image_is_difference ? imgutils::ConvertDifferenceImage(image, imgutils::DifferenceConversionMode::Offset) : image;
       cv::Mat_<double> raw_coefficients;
       const cv::Mat decomposed_image = Decompose(dct_input_image, raw_coefficients);
-      const cv::Mat combined_image = imgutils::CombineImages({difference_image, decomposed_image}, imgutils::CombinationMode::Horizontal, 1);
+      const cv::Mat &combined_image = imgutils::CombineImages({difference_image, decomposed_image}, canvas, imgutils::CombinationMode::Horizontal, 1);
       window.UpdateContent(combined_image);
       window.Zoom(zoom_factor);
       const double YSAD = imgutils::SAD(difference_image);
@@ -236,13 +240,14 @@ class prediction_data
 
     static void UpdateImages(prediction_data &data, const prediction_function_data &prediction_method)
     {
+      const comutils::TraceScope trace_scope("UpdateImages");
       constexpr auto zoom_factor = 7.5;
       cv::Mat original_block, predicted_block;
       data.ShowOriginal(zoom_factor);
       ShowPrediction(data.region, data.predicted_window, prediction_method.function, original_block, predicted_block, zoom_factor);
-      ShowDifferenceAndDCT(original_block, data.transformed_window, zoom_factor);
+      ShowDifferenceAndDCT(original_block, data.transformed_window, data.transformed_canvas, zoom_factor);
       const cv::Mat difference = imgutils::SubtractImages(original_block, predicted_block);
-      ShowDifferenceAndDCT(difference, data.predicted_transformed_window, zoom_factor, true);
+      ShowDifferenceAndDCT(difference, data.predicted_transformed_window, data.predicted_transformed_canvas, zoom_factor, true);
       data.ShowPredictionIllustration(prediction_method.illustration_function, zoom_factor);
     }
 
@@ -1,5 +1,5 @@
 //Illustration of motion estimation and motion compensation
-// Andreas Unterweger, 2016-2022
+// Andreas Unterweger, 2016-2026
 //This code is licensed under the 3-Clause BSD License. See LICENSE file for details.
 
 #include <iostream>
@@ -11,9 +11,12 @@
 #include <opencv2/imgproc.hpp>
 
 #include "combine.hpp"
+#include "canvas.hpp"
 #include "imgmath.hpp"
 #include "format.hpp"
 #include "colors.hpp"
+#include "framearena.hpp"
+#include "trace.hpp"
 #include "window.hpp"
 #include "multiwin.hpp"
 
@@ -28,6 +31,7 @@ class ME_data
     static_assert(border_size < (block_size + 1) / 2, "Border size must be smaller than half the block size");
   protected:
     imgutils::Window ME_window;
+    imgutils::Canvas ME_canvas; //Annotated reference image (left) and current image (right)
     
     using ButtonType = imgutils::Button<ME_data&>;
     ButtonType perform_button;
@@ -38,6 +42,7 @@ class ME_data
     MouseEventType ME_mouse_event;
     
     imgutils::Window MC_window;
+    imgutils::Canvas MC_canvas; //Searched block, current block and their difference
         
     imgutils::Window map_window;
     MouseEventType map_mouse_event;
@@ -95,7 +100,7 @@ class ME_data
       {
         const cv::Mat annotated_reference_image = GetAnnotatedReferenceImage(searched_block);
         const cv::Mat annotated_image = GetAnnotatedImage();
-        const cv::Mat combined_image = imgutils::CombineImages({annotated_reference_image, annotated_image}, imgutils::CombinationMode::Horizontal);
+        const cv::Mat &combined_image = imgutils::CombineImages({annotated_reference_image, annotated_image}, ME_canvas, imgutils::CombinationMode::Horizontal);
         ME_window.UpdateContent(combined_image);
         if (ME_window.IsShown())
         {
@@ -106,10 +111,10 @@ class ME_data
       return searched_block;
     }
 
-    static std::string GetDifferenceMetrics(const cv::Mat &difference, double &representative_metric_value)
+    static std::string GetDifferenceMetrics(const cv::Mat &block, const cv::Mat &reference_block, double &representative_metric_value)
     {
-      const double YSAD = imgutils::SAD(difference);
-      const double YSSD = imgutils::SSD(difference);
+      const double YSAD = imgutils::SAD(block, reference_block);
+      const double YSSD = imgutils::SSD(block, reference_block);
       representative_metric_value = YSSD;
       const double YMSE = YSSD / (block_size * block_size);
       const double YPSNR = imgutils::PSNR(YMSE);
@@ -120,13 +125,13 @@ class ME_data
     {
       const cv::Mat searched_block_pixels = reference_image(searched_block);
       const cv::Mat block_pixels = image(reference_block);
-      const cv::Mat compensated_block_pixels_16 = imgutils::SubtractImages(searched_block_pixels, block_pixels);
       double difference_value;
-      const std::string status_text = GetDifferenceMetrics(compensated_block_pixels_16, difference_value);
-      if (update_GUI)
+      const std::string status_text = GetDifferenceMetrics(searched_block_pixels, block_pixels, difference_value);
+      if (update_GUI) //The difference image is only required for displaying
       {
+        const cv::Mat compensated_block_pixels_16 = imgutils::SubtractImages(searched_block_pixels, block_pixels);
         const cv::Mat difference_image = imgutils::ConvertDifferenceImage(compensated_block_pixels_16);
-        const cv::Mat combined_image = imgutils::CombineImages({searched_block_pixels, block_pixels, difference_image}, imgutils::CombinationMode::Horizontal, 1);
+        const cv::Mat &combined_image = imgutils::CombineImages({searched_block_pixels, block_pixels, difference_image}, MC_canvas, imgutils::CombinationMode::Horizontal, 1);
         MC_window.UpdateContent(combined_image);
         MC_window.ZoomFully();
         if (MC_window.IsShown())
@@ -137,6 +142,7 @@ class ME_data
 
     double UpdateImages(const bool update_GUI = true)
     {
+      const comutils::TraceScope trace_scope("UpdateImages");
       const cv::Rect searched_block = UpdateMotionEstimationImage(update_GUI);
       return UpdateMotionCompensationImage(searched_block, update_GUI);
     }
@@ -177,6 +183,7 @@ class ME_data
 
     cv::Mat_<double> PerformMotionEstimation(const bool update_GUI = true)
     {
+      const comutils::TraceScope trace_scope("PerformMotionEstimation");
       constexpr auto ME_step_delay = 10; //Animation delay in ms
       cv::Mat_<double> cost_map(search_pixels, search_pixels, std::numeric_limits<double>::infinity());
       for (int y = -search_limit; y <= search_limit; y++)
@@ -185,6 +192,7 @@ class ME_data
         {
           if (update_GUI && !running) //Skip the rest when the user aborts
             return cost_map;
+          const imgutils::FrameArenaScope frame_scope; //Temporary images of each step are taken from an arena which is reused by the next step
           const cv::Point current_MV(x, y);
           const double current_cost = SetMotionVector(current_MV, update_GUI);
           cost_map(MVToMatrixPosition(current_MV)) = current_cost;